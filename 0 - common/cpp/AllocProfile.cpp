@@ -0,0 +1,114 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+/* Allocation profiling
+
+Compile with -DALLOC_PROFILE to replace the global operator new/delete with counting
+versions. Every allocation is charged to the active ProfileScope (paste Profiler.cpp
+above this) for the current turn, and turns are closed by Profiler::endTurn(). Once
+stdin has closed, the report names the turn with the most allocations, its peak live
+bytes, and the phases responsible. Without the switch, this compiles to nothing.
+
+*/
+
+#ifdef ALLOC_PROFILE
+
+namespace AllocProfile {
+  struct Counts {
+    long allocs = 0;
+    long bytes = 0;
+  };
+
+  struct Turn {
+    int number = 0;
+    Counts total;
+    long peakLive = 0;
+    Counts byPhase[Profiler::MAX_PHASES + 1];   // [0] is outside any phase
+  };
+
+  inline Turn now;
+  inline Turn worst;
+  inline long live = 0;
+
+  inline void record(size_t bytes) {
+    now.total.allocs += 1;
+    now.total.bytes += bytes;
+    live += bytes;
+    now.peakLive = max(now.peakLive, live);
+
+    Counts &phase = now.byPhase[Profiler::current + 1];
+    phase.allocs += 1;
+    phase.bytes += bytes;
+  }
+
+  inline void report() {
+    cerr << "Worst turn for allocations: turn " << worst.number << ", "
+      << worst.total.allocs << " allocs, " << worst.total.bytes << " bytes, "
+      << worst.peakLive << " peak live bytes" << endl;
+
+    // Phases from most allocations to least; a selection sort over a handful is fine
+    bool shown[Profiler::MAX_PHASES + 1] = {};
+    for (int rank = 0; rank <= Profiler::MAX_PHASES; ++rank) {
+      int top = -1;
+      for (int i = 0; i <= Profiler::MAX_PHASES; ++i)
+        if (!shown[i] && worst.byPhase[i].allocs > 0
+            && (top < 0 || worst.byPhase[i].allocs > worst.byPhase[top].allocs))
+          top = i;
+      if (top < 0)
+        break;
+
+      shown[top] = true;
+      cerr << "  " << Profiler::nameOf(top - 1) << ": "
+        << worst.byPhase[top].allocs << " allocs, "
+        << worst.byPhase[top].bytes << " bytes" << endl;
+    }
+  }
+
+  inline void closeTurn() {
+    if (now.total.allocs > worst.total.allocs)
+      worst = now;
+
+    int number = now.number;
+    now = Turn();
+    now.number = number + 1;
+    now.peakLive = live;
+  }
+
+  inline bool installed = [] {
+    Profiler::onTurnEnd = closeTurn;
+    Profiler::reporters[Profiler::reporterCount++] = report;
+    return true;
+  }();
+}
+
+// Each block carries its size in a header, so delete can keep the live count right.
+// Kept out of line; inlined into containers, GCC mistakes the header offset for a bug.
+const size_t ALLOC_HEADER = alignof(max_align_t);
+
+__attribute__((noinline)) void* operator new(size_t bytes) {
+  void* block = malloc(bytes + ALLOC_HEADER);
+  if (!block)
+    throw bad_alloc();
+  *static_cast<size_t*>(block) = bytes;
+  AllocProfile::record(bytes);
+  return static_cast<char*>(block) + ALLOC_HEADER;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  if (!p)
+    return;
+  void* block = static_cast<char*>(p) - ALLOC_HEADER;
+  AllocProfile::live -= *static_cast<size_t*>(block);
+  free(block);
+}
+
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+#endif
@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <algorithm>
+
+using namespace std;
+
+/** A bump allocator for per-turn scratch memory. One block is reserved up front;
+ * allocate() hands out aligned pieces of it by advancing an offset, and reset() at the
+ * end of the turn frees everything at once. Nothing is ever freed individually.
+ * Running out of the block throws bad_alloc, so size it for the worst turn. */
+class Arena {
+  unique_ptr<unsigned char[]> block;
+  size_t capacity;
+  size_t offset = 0;
+  size_t peak = 0;
+
+public:
+  Arena(size_t bytes) : block(new unsigned char[bytes]), capacity(bytes) { }
+
+  void* allocate(size_t bytes, size_t alignment = alignof(max_align_t)) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+    size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+
+    if (start + bytes > capacity)
+      throw bad_alloc();
+
+    offset = start + bytes;
+    peak = max(peak, offset);
+    return block.get() + start;
+  }
+
+  /** Frees everything allocated since construction or the last reset. */
+  void reset() { offset = 0; }
+
+  size_t used() const { return offset; }
+  size_t highWater() const { return peak; }
+};
+
+/** An STL allocator drawing from an Arena, so standard containers can live in turn
+ * scratch memory: vector<int, ArenaAllocator<int>> v(ArenaAllocator<int>(arena)).
+ * deallocate() is a no-op; memory comes back when the arena is reset, so containers
+ * using it must not outlive the turn. */
+template <class T>
+class ArenaAllocator {
+public:
+  using value_type = T;
+
+  Arena* arena;
+
+  ArenaAllocator(Arena &arena) : arena(&arena) { }
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) { }
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) { }
+
+  template <class U>
+  bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+  template <class U>
+  bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+};
@@ -0,0 +1,79 @@
+#include <array>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+using namespace std;
+
+/** A dense id→value container for small, frame-persistent entity ids.
+ * Values live contiguously in a fixed-capacity array in insertion order, so there is
+ * no per-entry node allocation and references handed out remain valid for the life
+ * of the map. Lookup is a single index into an id→slot table.
+ * @param T the value type; must be default-constructible. Slots are never erased or reused.
+ * @param Capacity the maximum number of distinct ids this map will ever hold. */
+template <class T, int Capacity>
+class IdSlotMap {
+  array<T, Capacity> values;
+  array<int, Capacity> ids;
+  vector<int> slotOf;   // id → slot, or -1 if unassigned
+  int count = 0;
+
+public:
+
+  int size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  T* begin() { return values.data(); }
+  T* end() { return values.data() + count; }
+  const T* begin() const { return values.data(); }
+  const T* end() const { return values.data() + count; }
+
+  /** Returns the entity id owning the value at the given slot. */
+  int idAt(int slot) const {
+    return ids[slot];
+  }
+
+  bool contains(int id) const {
+    return id >= 0 && id < int(slotOf.size()) && slotOf[id] >= 0;
+  }
+
+  /** Returns a pointer to the value for id, or nullptr if it has not been inserted. */
+  T* find(int id) {
+    return contains(id) ? &values[slotOf[id]] : nullptr;
+  }
+
+  const T* find(int id) const {
+    return contains(id) ? &values[slotOf[id]] : nullptr;
+  }
+
+  /** Returns a <value,bool> pair, where the bool is true if the id was newly inserted
+   * with a default value, and false if it was already present. */
+  pair<T&, bool> insert(int id) {
+    if (contains(id))
+      return {values[slotOf[id]], false};
+
+    if (id < 0)
+      throw invalid_argument("IdSlotMap ids must be non-negative.");
+    if (count == Capacity)
+      throw length_error("IdSlotMap is at capacity.");
+
+    if (id >= int(slotOf.size()))
+      slotOf.resize(id + 1, -1);
+
+    int slot = count++;
+    slotOf[id] = slot;
+    ids[slot] = id;
+    return {values[slot], true};
+  }
+
+  T& operator[](int id) {
+    return insert(id).first;
+  }
+
+  T& at(int id) {
+    T* value = find(id);
+    if (!value)
+      throw out_of_range("IdSlotMap has no entry for that id.");
+    return *value;
+  }
+};
@@ -80,15 +80,19 @@ public:
   }
 
   /** Yields a fast approximation of this Point's unit vector; returns a new Point.  
-   * The shape this creates is an octagon inscribed in the ideal circle.
+   * The shape this creates is an octagon inscribed in the ideal circle. The zero
+   * vector yields the zero vector. bench/geometry.cpp measures the error.
    * @author Nick Vogt */
   Point fastUnitVector() const {
+    if (x == 0 && y == 0)
+      return Point();
+
     // 0.29289 ~= 1 - 1/sqrt(2)
     // 1.29289 ~= 2 - 1/sqrt(2)
 
     double ax = x*(x >= 0) + -x*(x < 0);            // absolute coords
     double ay = y*(y >= 0) + -y*(y < 0);
-    double ratio = 1 / ( x*(x >= y) + y*(x < y));   // 1 / max(x, y)
+    double ratio = 1 / ( ax*(ax >= ay) + ay*(ax < ay));   // 1 / max(|x|, |y|)
     ratio = ratio * (1.29289 - (ax + ay) * ratio * 0.29289);
       // some trigonometry involving how diagonally-pointed the vector is
 
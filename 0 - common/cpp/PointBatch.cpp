@@ -0,0 +1,105 @@
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/** Points kept as separate x and y arrays rather than as Points, so the classifiers
+ * below can run through them eight at a time. Needs Point (Point.cpp) above it. */
+struct PointBatch {
+  vector<double> xs;
+  vector<double> ys;
+
+  void push_back(const Point &p) {
+    xs.push_back(p.x);
+    ys.push_back(p.y);
+  }
+
+  void clear() {
+    xs.clear();
+    ys.clear();
+  }
+
+  int size() const { return xs.size(); }
+};
+
+/** Bulk versions of the Point::crossZ sign tests, for scoring many candidate cells or
+ * positions at once. Each writes one result per point to `out`, which must have room
+ * for points.size() of them. Points are handled in blocks of LANES with a fixed inner
+ * loop, which the compiler turns into SIMD; the work is exact on integer coordinates
+ * up to about 2^26, which covers every board. bench/classify.cpp checks them against
+ * the scalar Point tests and times both. */
+namespace Classify {
+  const int LANES = 8;
+
+  inline int8_t sign(double v) {
+    return (v > 0) - (v < 0);
+  }
+
+  /** out[i] = +1 if the i'th point is left of the line A→B, -1 if right, 0 if on it. */
+  void side(const Point &A, const Point &B, const PointBatch &points, int8_t* out) {
+    const double* xs = points.xs.data();
+    const double* ys = points.ys.data();
+    const int n = points.size();
+    // Copied out of A and B: stores to `out` could alias them and force a reload per lane
+    const double ax = A.x, ay = A.y;
+    const double dx = B.x - ax, dy = B.y - ay;
+
+    int i = 0;
+    for (; i + LANES <= n; i += LANES)
+      for (int l = 0; l < LANES; ++l)
+        out[i + l] = sign(dx * (ys[i + l] - ay) - dy * (xs[i + l] - ax));
+    for (; i < n; ++i)
+      out[i] = sign(dx * (ys[i] - ay) - dy * (xs[i] - ax));
+  }
+
+  /** The clue a jump from → to would get were the target at each point: +1 for WARMER
+   * (nearer to `to`), -1 for COLDER, 0 for SAME (on the bisector). */
+  void clue(const Point &from, const Point &to, const PointBatch &points, int8_t* out) {
+    const double* xs = points.xs.data();
+    const double* ys = points.ys.data();
+    const int n = points.size();
+
+    // |p - to|^2 < |p - from|^2  <=>  2 p·(to - from) > |to|^2 - |from|^2
+    const double nx = 2 * (to.x - from.x), ny = 2 * (to.y - from.y);
+    const double offset = (to.x*to.x + to.y*to.y) - (from.x*from.x + from.y*from.y);
+
+    int i = 0;
+    for (; i + LANES <= n; i += LANES)
+      for (int l = 0; l < LANES; ++l)
+        out[i + l] = sign(nx * xs[i + l] + ny * ys[i + l] - offset);
+    for (; i < n; ++i)
+      out[i] = sign(nx * xs[i] + ny * ys[i] - offset);
+  }
+
+  /** out[i] = 1 if the i'th point is inside or on the edge of the convex polygon, else 0.
+   * The polygon may wind either way but must have some area. */
+  void insideConvex(const vector<Point> &polygon, const PointBatch &points, uint8_t* out) {
+    const double* xs = points.xs.data();
+    const double* ys = points.ys.data();
+    const int n = points.size();
+    const int sides = polygon.size();
+
+    double twiceArea = 0;
+    for (int s = 0; s < sides; ++s)
+      twiceArea += polygon[s].crossZ(polygon[(s + 1) % sides]);
+    const double winding = (twiceArea >= 0) ? 1 : -1;
+
+    for (int i = 0; i < n; ++i)
+      out[i] = 1;
+
+    // Inside means on the inner side of every edge; one pass over the points per edge
+    for (int s = 0; s < sides; ++s) {
+      const Point &A = polygon[s];
+      const Point &B = polygon[(s + 1) % sides];
+      const double ax = A.x, ay = A.y;
+      const double dx = winding * (B.x - ax), dy = winding * (B.y - ay);
+
+      int i = 0;
+      for (; i + LANES <= n; i += LANES)
+        for (int l = 0; l < LANES; ++l)
+          out[i + l] &= (dx * (ys[i + l] - ay) - dy * (xs[i + l] - ax)) >= 0;
+      for (; i < n; ++i)
+        out[i] &= (dx * (ys[i] - ay) - dy * (xs[i] - ax)) >= 0;
+    }
+  }
+}
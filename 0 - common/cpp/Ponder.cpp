@@ -0,0 +1,49 @@
+#include <iostream>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace std;
+
+/* Pondering
+
+The referee sends nothing until we've answered, so once a turn's input has been read,
+stdin is empty until the next turn arrives. The time between writing our command and
+that arrival is free search time. The pattern is:
+
+  out.flush();                                  // send this turn's command first
+  searcher.searchUntil(state, inputReady);      // keep growing this turn's tree
+  ...read input; build the real state...
+  searcher.search(actual, Deadline(TURN_MS));   // reuses the real state's subtree
+
+Pondering carries on from the state we just answered, not from a guess at the next one.
+The real next state is then one of the root's children: for DecoupledUct, the child
+for our move and whatever the opponent actually did. Uct and DecoupledUct (Search.cpp)
+keep that child's subtree, found by the real state's hash. Rerooting at a predicted
+state instead would discard all of its siblings, and with them the real state
+whenever the opponent didn't do as predicted. Some of the pondering goes on moves we
+didn't play; that's the price of never betting the tree on a guess.
+
+*/
+
+/** Returns true once there's input waiting on stdin, or stdin has closed.
+ * Never blocks. Checks cin's own buffer first, then polls the descriptor. */
+bool inputReady() {
+  if (cin.rdbuf()->in_avail() > 0)
+    return true;
+
+  pollfd fd {STDIN_FILENO, POLLIN, 0};
+  return poll(&fd, 1, 0) > 0;
+}
+
+/** Calls work() repeatedly until the next input arrives; returns how many times it ran.
+ * For searchers without a searchUntil(); keep each call short, a millisecond or so,
+ * since input is only checked between calls. */
+template <class Work>
+int ponder(Work work) {
+  int calls = 0;
+  while (!inputReady()) {
+    work();
+    ++calls;
+  }
+  return calls;
+}
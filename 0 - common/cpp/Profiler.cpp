@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+/** Named-phase timing. Open a ProfileScope at the top of a phase and it accrues calls
+ * and wall time to that name until it goes out of scope; nested scopes nest. The active
+ * phase is also what allocation and hardware-counter instrumentation attribute to.
+ * Phase tables are fixed-size arrays, so profiling never allocates.
+ *
+ * Compile with -DPROFILE to turn it on; ALLOC_PROFILE and PERF_COUNTERS turn it on too,
+ * since they attribute to its phases. Without a switch, ProfileScope is empty and
+ * endTurn() returns false straight away, so submitted bots pay nothing for the scopes. */
+#if defined(ALLOC_PROFILE) || defined(PERF_COUNTERS)
+#define PROFILE
+#endif
+
+#ifdef PROFILE
+
+namespace Profiler {
+  const int MAX_PHASES = 32;
+
+  struct Phase {
+    const char* name = nullptr;
+    long calls = 0;
+    double totalMs = 0;
+  };
+
+  inline Phase phases[MAX_PHASES];
+  inline int phaseCount = 0;
+  inline int current = -1;    // Index of the innermost open phase, or -1 outside any
+
+  /** Returns the index for a phase name, registering it on first use. */
+  inline int phaseId(const char* name) {
+    for (int i = 0; i < phaseCount; ++i)
+      if (phases[i].name == name || strcmp(phases[i].name, name) == 0)
+        return i;
+    if (phaseCount == MAX_PHASES)
+      return MAX_PHASES - 1;    // Out of room; lump the rest into the last phase
+    phases[phaseCount].name = name;
+    return phaseCount++;
+  }
+
+  inline const char* nameOf(int phase) {
+    return (phase < 0) ? "(no phase)" : phases[phase].name;
+  }
+
+  // Hooks for the optional instrumentation (AllocProfile.cpp, PerfCounters.cpp), which
+  // installs itself at startup when its build switch is on.
+  inline void (*onEnter)(int phase) = nullptr;
+  inline void (*onExit)(int phase) = nullptr;
+  inline void (*onTurnEnd)() = nullptr;
+  inline void (*reporters[4])() = {};
+  inline int reporterCount = 0;
+
+  inline void report() {
+    cerr << "Phase timings:" << endl;
+    for (int i = 0; i < phaseCount; ++i)
+      cerr << "  " << setw(24) << left << phases[i].name << right
+        << setw(8) << phases[i].calls << " calls "
+        << fixed << setprecision(3) << setw(10) << phases[i].totalMs << " ms" << endl;
+  }
+
+  /** Call once per turn, after the turn's output. Once stdin has closed, prints every
+   * report and returns true; the bot should then exit. Checking waits for the next
+   * turn's input, which is harmless with this turn's output already sent. */
+  inline bool endTurn() {
+    if (onTurnEnd)
+      onTurnEnd();
+
+    if ((cin >> ws).peek() != EOF)
+      return false;
+
+    report();
+    for (int i = 0; i < reporterCount; ++i)
+      reporters[i]();
+    return true;
+  }
+}
+
+class ProfileScope {
+  using Clock = chrono::steady_clock;
+
+  int phase;
+  int parent;
+  Clock::time_point start;
+
+public:
+  ProfileScope(const char* name)
+  : phase(Profiler::phaseId(name)),
+    parent(Profiler::current),
+    start(Clock::now())
+  {
+    Profiler::current = phase;
+    if (Profiler::onEnter)
+      Profiler::onEnter(phase);
+  }
+
+  ~ProfileScope() {
+    if (Profiler::onExit)
+      Profiler::onExit(phase);
+
+    Profiler::Phase &p = Profiler::phases[phase];
+    p.calls += 1;
+    p.totalMs += chrono::duration<double, milli>(Clock::now() - start).count();
+    Profiler::current = parent;
+  }
+};
+
+#else
+
+namespace Profiler {
+  inline bool endTurn() { return false; }
+}
+
+class ProfileScope {
+public:
+  ProfileScope(const char*) { }
+};
+
+#endif
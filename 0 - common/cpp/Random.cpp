@@ -0,0 +1,168 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+/** wyrand; a 64-bit generator with one multiply per draw and a single word of state.
+ * Passes BigCrush and is several times quicker than mt19937 plus a <random> distribution.
+ * Seeded explicitly so that a game can be replayed: log the seed at startup. */
+class Rng {
+  uint64_t state;
+
+public:
+  Rng(uint64_t seed) : state(seed) { }
+
+  /** A seed that differs between runs. Print it to cerr so the run can be reproduced. */
+  static uint64_t seedFromClock() {
+    return chrono::steady_clock::now().time_since_epoch().count();
+  }
+
+  uint64_t next() {
+    state += 0xA0761D6478BD642Full;
+    __uint128_t m = __uint128_t(state) * (state ^ 0xE7037ED1A0B428DBull);
+    return uint64_t(m >> 64) ^ uint64_t(m);
+  }
+
+  /** Uniform in [0, n), n > 0, by Lemire's multiply-shift with rejection; unbiased. The
+   * rejection step needs a division, but it's only reached with probability n / 2^32. */
+  uint32_t bounded(uint32_t n) {
+    uint64_t m = uint64_t(uint32_t(next())) * n;
+    if (uint32_t(m) < n) {
+      uint32_t threshold = (0u - n) % n;    // 2^32 mod n
+      while (uint32_t(m) < threshold)
+        m = uint64_t(uint32_t(next())) * n;
+    }
+    return uint32_t(m >> 32);
+  }
+
+  /** Uniform in [min, max]; any ints, including the full range of int. */
+  int range(int min, int max) {
+    uint64_t span = uint64_t(int64_t(max) - min) + 1;
+    uint32_t offset = (span > UINT32_MAX) ? uint32_t(next()) : bounded(uint32_t(span));
+    return int(int64_t(min) + offset);
+  }
+
+  /** Uniform in [0, 1), with 53 bits of precision. */
+  double unit() {
+    return (next() >> 11) * 0x1.0p-53;
+  }
+
+  bool chance(double p) {
+    return unit() < p;
+  }
+
+  /** Uniform over the disc of the given radius about center. P is any type with an
+   * (x, y) constructor and x, y members, like the bots' Point classes. */
+  template <class P>
+  P pointInDisc(const P &center, double radius) {
+    double r = radius * sqrt(unit());
+    double theta = 6.283185307179586 * unit();
+    return P(center.x + r * cos(theta), center.y + r * sin(theta));
+  }
+
+  /** Uniform over a convex polygon given by its vertices in order (either winding).
+   * Picks a fan triangle weighted by area, then a uniform point within it. */
+  template <class P, class Container>
+  P pointInConvexPolygon(const Container &vertices) {
+    const P &origin = *vertices.begin();
+    int n = vertices.size();
+
+    auto area = [&](int i) {
+      const P &b = vertices[i];
+      const P &c = vertices[i + 1];
+      return abs((b.x - origin.x) * (c.y - origin.y) - (b.y - origin.y) * (c.x - origin.x));
+    };
+
+    double total = 0;
+    for (int i = 1; i + 1 < n; ++i)
+      total += area(i);
+
+    double pick = unit() * total;
+    int tri = 1;
+    for (; tri + 2 < n; ++tri) {
+      pick -= area(tri);
+      if (pick < 0)
+        break;
+    }
+
+    // Fold the unit square onto the triangle
+    double s = unit(), t = unit();
+    if (s + t > 1) {
+      s = 1 - s;
+      t = 1 - t;
+    }
+    const P &b = vertices[tri];
+    const P &c = vertices[tri + 1];
+    return P(
+      origin.x + s * (b.x - origin.x) + t * (c.x - origin.x),
+      origin.y + s * (b.y - origin.y) + t * (c.y - origin.y));
+  }
+};
+
+/** Eight independent xoshiro128+ streams advanced in lockstep, laid out so the compiler
+ * can keep all lanes in one SIMD register. For filling large buffers of random numbers
+ * (rollout noise, GA mutations) in bulk. */
+class RngLanes {
+  static const int LANES = 8;
+  uint32_t s0[LANES], s1[LANES], s2[LANES], s3[LANES];
+
+  static uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+  }
+
+public:
+  RngLanes(uint64_t seed) {
+    Rng seeder(seed);
+    for (int i = 0; i < LANES; ++i) {
+      uint64_t a = seeder.next(), b = seeder.next();
+      s0[i] = uint32_t(a);
+      s1[i] = uint32_t(a >> 32) | 1;    // xoshiro must not start all-zero
+      s2[i] = uint32_t(b);
+      s3[i] = uint32_t(b >> 32);
+    }
+  }
+
+  /** Writes n random 32-bit values; n need not be a multiple of eight. */
+  void fill(uint32_t* out, int n) {
+    // Work on local copies so the compiler knows `out` can't alias the state
+    uint32_t a[LANES], b[LANES], c[LANES], d[LANES], batch[LANES];
+    for (int i = 0; i < LANES; ++i) {
+      a[i] = s0[i]; b[i] = s1[i]; c[i] = s2[i]; d[i] = s3[i];
+    }
+
+    for (int done = 0; done < n; done += LANES) {
+      for (int i = 0; i < LANES; ++i) {
+        batch[i] = a[i] + d[i];
+        uint32_t t = b[i] << 9;
+        c[i] ^= a[i];
+        d[i] ^= b[i];
+        b[i] ^= c[i];
+        a[i] ^= d[i];
+        c[i] ^= t;
+        d[i] = rotl(d[i], 11);
+      }
+
+      if (done + LANES <= n)
+        for (int i = 0; i < LANES; ++i)
+          out[done + i] = batch[i];
+      else
+        for (int i = 0; done + i < n; ++i)
+          out[done + i] = batch[i];
+    }
+
+    for (int i = 0; i < LANES; ++i) {
+      s0[i] = a[i]; s1[i] = b[i]; s2[i] = c[i]; s3[i] = d[i];
+    }
+  }
+
+  /** Writes n floats uniform in [0, 1), with 24 bits of precision. */
+  void fillUnit(float* out, int n) {
+    uint32_t batch[LANES];
+    for (int done = 0; done < n; done += LANES) {
+      fill(batch, LANES);
+      for (int i = 0; i < LANES && done + i < n; ++i)
+        out[done + i] = (batch[i] >> 8) * 0x1.0p-24f;
+    }
+  }
+};
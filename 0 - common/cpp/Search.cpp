@@ -0,0 +1,599 @@
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+/* State concept
+
+Each searcher here is a template over some game State, a copyable snapshot of the
+game which provides whichever of these members that searcher needs:
+
+  using Action = ...;                                       // default-constructible, copyable
+  void legalActions(vector<Action> &out) const;             // Uct, BeamSearch
+  void legalActions(int player, vector<Action> &out) const; // DecoupledUct; player is 0 or 1
+  void apply(const Action &action);                         // Uct, BeamSearch
+  void apply(const Action &mine, const Action &theirs);     // DecoupledUct
+  double evaluate() const;    // Score from player 0's view. Uct and DecoupledUct want [0,1].
+  uint64_t hash() const;      // Identity; used for tree reuse and beam de-duplication.
+
+legalActions() should yield nothing for terminal states. Actions are applied to a copy
+of the root state once per iteration, so the cheaper State is to copy, the better.
+
+*/
+
+/** A turn-time budget, measured from construction. */
+class Deadline {
+  using Clock = chrono::steady_clock;
+  Clock::time_point end;
+
+public:
+  Deadline(double ms)
+  : end(Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms)))
+  { }
+
+  bool passed() const {
+    return Clock::now() >= end;
+  }
+
+  double remainingMs() const {
+    return chrono::duration<double, milli>(end - Clock::now()).count();
+  }
+};
+
+/** Fixed-capacity object pool addressed by index. Allocation is a bump of a counter,
+ * and reset() frees everything in O(1); the backing memory is only ever allocated once. */
+template <class T>
+class NodeArena {
+  vector<T> items;
+  int count = 0;
+
+public:
+  NodeArena(int capacity) : items(capacity) { }
+
+  int size() const { return count; }
+  int capacity() const { return items.size(); }
+  bool full(int n = 1) const { return count + n > capacity(); }
+
+  /** Returns the index of the first of n freshly-initialized, contiguous items. */
+  int alloc(int n = 1) {
+    int first = count;
+    count += n;
+    fill(items.begin() + first, items.begin() + count, T());
+    return first;
+  }
+
+  void reset() { count = 0; }
+
+  void swap(NodeArena &other) {
+    items.swap(other.items);
+    std::swap(count, other.count);
+  }
+
+  T& operator[](int i) { return items[i]; }
+  const T& operator[](int i) const { return items[i]; }
+};
+
+/** Monte Carlo tree search with UCB1 selection for a single deciding agent; anything
+ * the other side does is expected to be folded into State::apply. Leaves are scored
+ * by State::evaluate rather than by random playout.
+ *
+ * The tree persists between calls to search(): if the new root state's hash matches
+ * the old root or one of its children, that subtree is kept and the rest discarded. */
+template <class State>
+class Uct {
+public:
+  using Action = typename State::Action;
+
+  struct Node {
+    Action action;          // The action which led to this node.
+    uint64_t hash = 0;      // Hash of this node's state; only known once visited.
+    int visits = 0;
+    double value = 0;       // Sum of evaluations backed up through this node.
+    int firstChild = -1;
+    int childCount = 0;
+    bool expanded = false;
+  };
+
+  double exploration = 1.41;
+  int maxDepth = 64;
+  int iterations = 0;       // Iterations performed by the last search() call.
+
+  Uct(int capacity) : nodes(capacity), spare(capacity) { }
+
+  /** Searches from root until the deadline passes or the arena fills, then returns the
+   * most visited root action, or a default Action if root has no legal actions. */
+  Action search(const State &root, const Deadline &deadline) {
+    return searchUntil(root, [&deadline]() { return deadline.passed(); });
+  }
+
+  /** As search(), but runs until stop() returns true. Used for pondering: searching on
+   * from the state just answered until input arrives, so the next search() can keep
+   * the subtree under whichever child the game actually reached. */
+  template <class Stop>
+  Action searchUntil(const State &root, Stop stop) {
+    reuseTree(root);
+
+    iterations = 0;
+    while (!stop()) {
+      for (int i = 0; i < 64; ++i)    // Clock checks aren't free; batch iterations.
+        iterate(root);
+      iterations += 64;
+      if (nodes.full())
+        break;
+    }
+
+    return bestAction();
+  }
+
+  const Node& rootNode() const {
+    return nodes[0];
+  }
+
+private:
+  NodeArena<Node> nodes;
+  NodeArena<Node> spare;
+  vector<int> path;
+  vector<Action> actions;
+  vector<pair<int,int>> copyStack;
+
+  void reuseTree(const State &root) {
+    uint64_t hash = root.hash();
+    int keep = -1;
+
+    if (nodes.size() > 0) {
+      if (nodes[0].hash == hash)
+        keep = 0;
+      for (int i = 0; keep < 0 && i < nodes[0].childCount; ++i)
+        if (nodes[nodes[0].firstChild + i].hash == hash)
+          keep = nodes[0].firstChild + i;
+    }
+
+    if (keep > 0)
+      keepSubtree(keep);
+    else if (keep < 0) {
+      nodes.reset();
+      nodes.alloc();
+    }
+    nodes[0].hash = hash;
+  }
+
+  /** Copies the subtree at src into the spare arena as its new root, then swaps arenas. */
+  void keepSubtree(int src) {
+    spare.reset();
+    spare[spare.alloc()] = nodes[src];
+    copyStack.clear();
+    copyStack.push_back({src, 0});
+
+    while (!copyStack.empty()) {
+      auto [from, to] = copyStack.back();
+      copyStack.pop_back();
+
+      int count = nodes[from].childCount;
+      if (count == 0)
+        continue;
+
+      int first = spare.alloc(count);
+      spare[to].firstChild = first;
+      for (int i = 0; i < count; ++i) {
+        spare[first + i] = nodes[nodes[from].firstChild + i];
+        copyStack.push_back({nodes[from].firstChild + i, first + i});
+      }
+    }
+
+    nodes.swap(spare);
+  }
+
+  void expand(int node, const State &state) {
+    nodes[node].expanded = true;
+    actions.clear();
+    state.legalActions(actions);
+
+    if (actions.empty() || nodes.full(actions.size()))
+      return;
+
+    int first = nodes.alloc(actions.size());
+    for (int i = 0; i < int(actions.size()); ++i)
+      nodes[first + i].action = actions[i];
+    nodes[node].firstChild = first;
+    nodes[node].childCount = actions.size();
+  }
+
+  int select(int node) const {
+    const Node &parent = nodes[node];
+    double logVisits = log(double(parent.visits) + 1);
+    int best = -1;
+    double bestScore = -1;
+
+    for (int i = parent.firstChild; i < parent.firstChild + parent.childCount; ++i) {
+      const Node &child = nodes[i];
+      if (child.visits == 0)
+        return i;
+
+      double score = child.value / child.visits
+        + exploration * sqrt(logVisits / child.visits);
+      if (best < 0 || score > bestScore) {
+        best = i;
+        bestScore = score;
+      }
+    }
+    return best;
+  }
+
+  void iterate(const State &root) {
+    State state = root;
+    path.clear();
+    path.push_back(0);
+
+    int node = 0;
+    for (int depth = 0; depth < maxDepth; ++depth) {
+      if (!nodes[node].expanded)
+        expand(node, state);
+      if (nodes[node].childCount == 0)
+        break;
+
+      int child = select(node);
+      state.apply(nodes[child].action);
+      path.push_back(child);
+      node = child;
+
+      if (nodes[child].visits == 0) {
+        nodes[child].hash = state.hash();
+        break;
+      }
+    }
+
+    double value = state.evaluate();
+    for (int i : path) {
+      nodes[i].visits += 1;
+      nodes[i].value += value;
+    }
+  }
+
+  Action bestAction() const {
+    const Node &root = nodes[0];
+    int best = -1;
+    for (int i = root.firstChild; i < root.firstChild + root.childCount; ++i)
+      if (best < 0 || nodes[i].visits > nodes[best].visits)
+        best = i;
+    return (best < 0) ? Action() : nodes[best].action;
+  }
+};
+
+/** Decoupled UCT for two-player simultaneous-move games. Each node keeps separate
+ * UCB1 statistics for each player's own actions, each player selects independently,
+ * and the joint action picks the child. Player 0's reward is evaluate(), and player 1's
+ * is 1 - evaluate().
+ *
+ * Like Uct, the tree is kept between turns: both players' moves are applied in one
+ * step, so the old root's direct children (one joint move later) are checked for the
+ * new root's hash. */
+template <class State>
+class DecoupledUct {
+public:
+  using Action = typename State::Action;
+
+  struct Stat {
+    Action action;
+    int visits = 0;
+    double value = 0;
+  };
+
+  struct Node {
+    uint64_t hash = 0;
+    int visits = 0;
+    int firstStat[2] = {-1, -1};
+    int statCount[2] = {0, 0};
+    int firstChild = -1;    // Index into the children arena: statCount[0] * statCount[1] slots.
+    bool expanded = false;
+  };
+
+  double exploration = 1.41;
+  int maxDepth = 32;
+  int iterations = 0;
+
+  DecoupledUct(int capacity)
+  : nodes(capacity), stats(capacity * 4), children(capacity * 8),
+    spareNodes(capacity), spareStats(capacity * 4), spareChildren(capacity * 8)
+  { }
+
+  /** Searches until the deadline, then returns player 0's most visited root action. */
+  Action search(const State &root, const Deadline &deadline) {
+    return searchUntil(root, [&deadline]() { return deadline.passed(); });
+  }
+
+  /** As search(), but runs until stop() returns true; see Uct::searchUntil. */
+  template <class Stop>
+  Action searchUntil(const State &root, Stop stop) {
+    reuseTree(root);
+
+    iterations = 0;
+    while (!stop()) {
+      for (int i = 0; i < 64; ++i)
+        iterate(root);
+      iterations += 64;
+      if (nodes.full() || stats.full() || children.full())
+        break;
+    }
+
+    const Node &node = nodes[0];
+    int best = -1;
+    for (int i = node.firstStat[0]; i < node.firstStat[0] + node.statCount[0]; ++i)
+      if (best < 0 || stats[i].visits > stats[best].visits)
+        best = i;
+    return (best < 0) ? Action() : stats[best].action;
+  }
+
+private:
+  NodeArena<Node> nodes;
+  NodeArena<Stat> stats;
+  NodeArena<int> children;
+  NodeArena<Node> spareNodes;
+  NodeArena<Stat> spareStats;
+  NodeArena<int> spareChildren;
+
+  vector<pair<int,int>> path;   // <node, joint child slot> pairs
+  vector<Action> actions;
+  vector<pair<int,int>> copyStack;
+
+  int childSlots(const Node &node) const {
+    return node.statCount[0] * node.statCount[1];
+  }
+
+  void reuseTree(const State &root) {
+    uint64_t hash = root.hash();
+    int keep = -1;
+
+    if (nodes.size() > 0) {
+      if (nodes[0].hash == hash)
+        keep = 0;
+
+      // Our move and theirs are both applied in one step, so the next turn's root is a child.
+      const Node &node = nodes[0];
+      for (int i = 0; keep < 0 && i < childSlots(node); ++i) {
+        int child = children[node.firstChild + i];
+        if (child >= 0 && nodes[child].hash == hash)
+          keep = child;
+      }
+    }
+
+    if (keep > 0)
+      keepSubtree(keep);
+    else if (keep < 0) {
+      nodes.reset();
+      stats.reset();
+      children.reset();
+      nodes.alloc();
+    }
+    nodes[0].hash = hash;
+  }
+
+  int copyNode(int from) {
+    int to = spareNodes.alloc();
+    Node node = nodes[from];
+
+    for (int p = 0; p < 2; ++p) {
+      if (node.statCount[p] == 0)
+        continue;
+      int first = spareStats.alloc(node.statCount[p]);
+      for (int i = 0; i < node.statCount[p]; ++i)
+        spareStats[first + i] = stats[node.firstStat[p] + i];
+      node.firstStat[p] = first;
+    }
+
+    int slots = childSlots(node);
+    if (slots > 0) {
+      int first = spareChildren.alloc(slots);
+      for (int i = 0; i < slots; ++i) {
+        spareChildren[first + i] = -1;
+        if (children[node.firstChild + i] >= 0)
+          copyStack.push_back({children[node.firstChild + i], first + i});
+      }
+      node.firstChild = first;
+    }
+
+    spareNodes[to] = node;
+    return to;
+  }
+
+  /** Copies the subtree at src into the spare arenas as its new root, then swaps arenas. */
+  void keepSubtree(int src) {
+    spareNodes.reset();
+    spareStats.reset();
+    spareChildren.reset();
+    copyStack.clear();
+
+    copyNode(src);
+    while (!copyStack.empty()) {
+      auto [from, slot] = copyStack.back();
+      copyStack.pop_back();
+      spareChildren[slot] = copyNode(from);
+    }
+
+    nodes.swap(spareNodes);
+    stats.swap(spareStats);
+    children.swap(spareChildren);
+  }
+
+  /** Returns false if the arenas could not hold the expansion. */
+  bool expand(int node, const State &state) {
+    nodes[node].expanded = true;
+
+    int counts[2];
+    int firsts[2];
+    for (int p = 0; p < 2; ++p) {
+      actions.clear();
+      state.legalActions(p, actions);
+      counts[p] = actions.size();
+      if (counts[p] == 0 || stats.full(counts[p]))
+        return false;
+
+      firsts[p] = stats.alloc(counts[p]);
+      for (int i = 0; i < counts[p]; ++i)
+        stats[firsts[p] + i].action = actions[i];
+    }
+
+    if (children.full(counts[0] * counts[1]))
+      return false;
+
+    int first = children.alloc(counts[0] * counts[1]);
+    fill(&children[first], &children[first] + counts[0] * counts[1], -1);
+
+    for (int p = 0; p < 2; ++p) {
+      nodes[node].firstStat[p] = firsts[p];
+      nodes[node].statCount[p] = counts[p];
+    }
+    nodes[node].firstChild = first;
+    return true;
+  }
+
+  int select(const Node &node, int player) const {
+    double logVisits = log(double(node.visits) + 1);
+    int first = node.firstStat[player];
+    int best = -1;
+    double bestScore = -1;
+
+    for (int i = 0; i < node.statCount[player]; ++i) {
+      const Stat &stat = stats[first + i];
+      if (stat.visits == 0)
+        return i;
+
+      double score = stat.value / stat.visits
+        + exploration * sqrt(logVisits / stat.visits);
+      if (best < 0 || score > bestScore) {
+        best = i;
+        bestScore = score;
+      }
+    }
+    return best;
+  }
+
+  void iterate(const State &root) {
+    State state = root;
+    path.clear();
+
+    int node = 0;
+    for (int depth = 0; depth < maxDepth; ++depth) {
+      if (!nodes[node].expanded && !expand(node, state))
+        break;
+      if (nodes[node].statCount[0] == 0)
+        break;
+
+      const Node &current = nodes[node];
+      int a = select(current, 0);
+      int b = select(current, 1);
+      int slot = current.firstChild + a * current.statCount[1] + b;
+
+      state.apply(stats[current.firstStat[0] + a].action, stats[current.firstStat[1] + b].action);
+      path.push_back({node, a * current.statCount[1] + b});
+
+      int child = children[slot];
+      if (child < 0) {
+        if (nodes.full())
+          break;
+        child = nodes.alloc();
+        children[slot] = child;
+        nodes[child].hash = state.hash();
+        node = child;
+        break;
+      }
+      node = child;
+    }
+
+    double value = state.evaluate();
+    nodes[node].visits += 1;
+    for (auto [n, joint] : path) {
+      Node &parent = nodes[n];
+      int a = joint / parent.statCount[1];
+      int b = joint % parent.statCount[1];
+      parent.visits += 1;
+
+      Stat &mine = stats[parent.firstStat[0] + a];
+      Stat &theirs = stats[parent.firstStat[1] + b];
+      mine.visits += 1;
+      mine.value += value;
+      theirs.visits += 1;
+      theirs.value += 1 - value;
+    }
+  }
+};
+
+/** Fixed-width beam search. Each layer expands every state in the beam, drops
+ * duplicates by hash, and keeps the best `width` children by evaluate(). Returns the
+ * first action along the best line found, whether or not the deadline cut it short. */
+template <class State>
+class BeamSearch {
+public:
+  using Action = typename State::Action;
+
+  struct Candidate {
+    State state;
+    Action first;       // The root action this line began with.
+    double score = 0;
+    uint64_t hash = 0;
+  };
+
+  int width;
+  int depth;
+  int layers = 0;       // Layers completed by the last search() call.
+
+  BeamSearch(int width, int depth) : width(width), depth(depth) {
+    beam.reserve(width);
+  }
+
+  Action search(const State &root, const Deadline &deadline) {
+    beam.clear();
+    beam.push_back({root, Action(), root.evaluate(), root.hash()});
+
+    bool haveBest = false;
+    Action bestFirst = Action();
+    double bestScore = 0;
+
+    for (layers = 0; layers < depth && !deadline.passed(); ++layers) {
+      next.clear();
+      for (auto &candidate : beam) {
+        actions.clear();
+        candidate.state.legalActions(actions);
+        for (auto &action : actions) {
+          State state = candidate.state;
+          state.apply(action);
+          Action first = (layers == 0) ? action : candidate.first;
+          next.push_back({state, first, state.evaluate(), state.hash()});
+        }
+      }
+
+      if (next.empty())
+        break;
+
+      // Keep only the best scoring line per distinct state
+      sort(next.begin(), next.end(), [](const Candidate &a, const Candidate &b) {
+        return (a.hash != b.hash) ? a.hash < b.hash : a.score > b.score;
+      });
+      next.erase(unique(next.begin(), next.end(),
+        [](const Candidate &a, const Candidate &b) { return a.hash == b.hash; }), next.end());
+
+      int kept = min<int>(width, next.size());
+      partial_sort(next.begin(), next.begin() + kept, next.end(),
+        [](const Candidate &a, const Candidate &b) { return a.score > b.score; });
+      next.resize(kept);
+
+      if (!haveBest || next[0].score > bestScore) {
+        bestFirst = next[0].first;
+        bestScore = next[0].score;
+        haveBest = true;
+      }
+
+      beam.swap(next);
+    }
+
+    return bestFirst;
+  }
+
+private:
+  vector<Candidate> beam;
+  vector<Candidate> next;
+  vector<Action> actions;
+};
@@ -0,0 +1,134 @@
+#include <new>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+
+using namespace std;
+
+/** A vector with fixed, inline capacity: the elements live inside the object itself, so
+ * a StaticVector on the stack never touches the heap. Supports the subset of std::vector
+ * the bots use, including back_inserter and the <algorithm> iterator functions.
+ * Growing past N throws length_error rather than reallocating. */
+template <class T, int N>
+class StaticVector {
+  alignas(T) unsigned char storage[N * sizeof(T)];
+  int count = 0;
+
+public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using size_type = int;
+
+  StaticVector() { }
+
+  StaticVector(initializer_list<T> items) {
+    for (auto &item : items)
+      push_back(item);
+  }
+
+  template <class Iter>
+  StaticVector(Iter first, Iter last) {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  StaticVector(const StaticVector &other) {
+    for (auto &item : other)
+      push_back(item);
+  }
+
+  StaticVector& operator=(const StaticVector &other) {
+    if (this != &other) {
+      clear();
+      for (auto &item : other)
+        push_back(item);
+    }
+    return *this;
+  }
+
+  ~StaticVector() {
+    clear();
+  }
+
+  T* data() { return reinterpret_cast<T*>(storage); }
+  const T* data() const { return reinterpret_cast<const T*>(storage); }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + count; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + count; }
+
+  int size() const { return count; }
+  bool empty() const { return count == 0; }
+  bool full() const { return count == N; }
+  static constexpr int capacity() { return N; }
+
+  T& operator[](int i) { return data()[i]; }
+  const T& operator[](int i) const { return data()[i]; }
+
+  T& at(int i) {
+    if (i < 0 || i >= count)
+      throw out_of_range("StaticVector index out of range.");
+    return data()[i];
+  }
+
+  T& front() { return data()[0]; }
+  T& back() { return data()[count - 1]; }
+  const T& front() const { return data()[0]; }
+  const T& back() const { return data()[count - 1]; }
+
+  template <class... Args>
+  T& emplace_back(Args&&... args) {
+    if (count == N)
+      throw length_error("StaticVector is at capacity.");
+    T* item = new (data() + count) T(forward<Args>(args)...);
+    ++count;
+    return *item;
+  }
+
+  void push_back(const T &item) { emplace_back(item); }
+  void push_back(T &&item) { emplace_back(move(item)); }
+
+  void pop_back() {
+    data()[--count].~T();
+  }
+
+  void clear() {
+    while (count > 0)
+      pop_back();
+  }
+
+  void resize(int n) {
+    while (count > n)
+      pop_back();
+    while (count < n)
+      emplace_back();
+  }
+
+  template <class Iter>
+  void assign(Iter first, Iter last) {
+    clear();
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  /** Removes the element at pos by shifting the rest down; returns the following position. */
+  iterator erase(iterator pos) {
+    for (iterator it = pos; it + 1 != end(); ++it)
+      *it = move(*(it + 1));
+    pop_back();
+    return pos;
+  }
+
+  iterator erase(iterator first, iterator last) {
+    iterator out = first;
+    for (iterator it = last; it != end(); ++it, ++out)
+      *out = move(*it);
+    while (end() != out)
+      pop_back();
+    return first;
+  }
+};
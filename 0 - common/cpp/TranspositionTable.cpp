@@ -0,0 +1,180 @@
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cmath>
+
+using namespace std;
+
+/** splitmix64; a fast, well-mixed 64-bit sequence, used here to fill key tables. */
+uint64_t splitmix64(uint64_t &state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/** Zobrist keys for entities on a board discretised into square cells.
+ * A state's hash is the XOR of key(kind, cell) over its entities, so moving one entity
+ * is two XORs: hash ^= key(kind, oldCell) ^ key(kind, newCell). Kinds are whatever the
+ * caller wants to tell apart: entity types, ids, or an id-and-hp bucket, say. */
+class ZobristKeys {
+  vector<uint64_t> keys;
+
+public:
+  const int kinds;
+  const int columns;
+  const int rows;
+  const double cellSize;
+
+  /** @param width,height board dimensions, in game units.
+   * @param cellSize the width of a cell; positions within the same cell hash equal.
+   * @param seed fixed by default so hashes are reproducible between runs. */
+  ZobristKeys(int kinds, double width, double height, double cellSize, uint64_t seed = 0x5EED)
+  : kinds(kinds),
+    columns(int(ceil(width / cellSize)) + 1),
+    rows(int(ceil(height / cellSize)) + 1),
+    cellSize(cellSize)
+  {
+    keys.resize(size_t(kinds) * columns * rows);
+    for (auto &key : keys)
+      key = splitmix64(seed);
+  }
+
+  /** Returns the cell index for a position; off-board positions are clamped to the edge. */
+  int cell(double x, double y) const {
+    int cx = max(0, min(columns - 1, int(x / cellSize)));
+    int cy = max(0, min(rows - 1, int(y / cellSize)));
+    return cy * columns + cx;
+  }
+
+  uint64_t key(int kind, int cell) const {
+    return keys[size_t(kind) * columns * rows + cell];
+  }
+
+  uint64_t key(int kind, double x, double y) const {
+    return key(kind, cell(x, y));
+  }
+};
+
+/** What a search remembers about a state. Packs to exactly 64 bits. */
+struct TTEntry {
+  enum Bound : uint8_t { None = 0, Exact = 1, Lower = 2, Upper = 3 };
+
+  int32_t score = 0;
+  uint16_t move = 0;    // Index of the best action found, or whatever the search likes.
+  uint8_t depth = 0;    // Remaining depth the score was searched to.
+  Bound bound = None;
+};
+
+/** A fixed-size hash table of search results keyed by 64-bit state hashes.
+ * The table is a power-of-two array of cache-line-sized buckets of four entries. A
+ * store replaces, in order of preference: the same key, an empty slot, then whichever
+ * entry is shallowest after penalising entries left over from older searches.
+ *
+ * Entries are two relaxed atomics holding (key ^ data) and data, so concurrent readers
+ * and writers need no locks: a probe that races a store sees a key mismatch and simply
+ * misses instead of returning a torn entry. */
+class TranspositionTable {
+  struct Slot {
+    atomic<uint64_t> check {0};   // key ^ data
+    atomic<uint64_t> data {0};
+  };
+
+  struct alignas(64) Bucket {
+    Slot slots[4];
+  };
+
+  unique_ptr<Bucket[]> buckets;
+  uint64_t mask;
+  uint8_t generation = 0;   // 5 bits; shares a byte with the bound and OCCUPIED
+
+  // Set in every stored entry, so no entry packs to 0, which marks an empty slot
+  static const uint64_t OCCUPIED = uint64_t(1) << 63;
+
+  static uint64_t pack(const TTEntry &entry, uint8_t generation) {
+    return uint64_t(uint32_t(entry.score))
+      | uint64_t(entry.move) << 32
+      | uint64_t(entry.depth) << 48
+      | uint64_t(entry.bound | generation << 2) << 56
+      | OCCUPIED;
+  }
+
+  static TTEntry unpack(uint64_t data) {
+    TTEntry entry;
+    entry.score = int32_t(uint32_t(data));
+    entry.move = uint16_t(data >> 32);
+    entry.depth = uint8_t(data >> 48);
+    entry.bound = TTEntry::Bound((data >> 56) & 3);
+    return entry;
+  }
+
+  static uint8_t generationOf(uint64_t data) {
+    return uint8_t(data >> 58) & 31;
+  }
+
+  static uint8_t depthOf(uint64_t data) {
+    return uint8_t(data >> 48);
+  }
+
+public:
+  /** @param log2Buckets the table holds 4 << log2Buckets entries, 16 bytes apiece. */
+  TranspositionTable(int log2Buckets)
+  : buckets(new Bucket[size_t(1) << log2Buckets]),
+    mask((uint64_t(1) << log2Buckets) - 1)
+  { }
+
+  /** Ages every entry at once, so this search's results win replacement over old ones. */
+  void newSearch() {
+    generation = (generation + 1) & 31;
+  }
+
+  void clear() {
+    for (uint64_t b = 0; b <= mask; ++b)
+      for (auto &slot : buckets[b].slots) {
+        slot.check.store(0, memory_order_relaxed);
+        slot.data.store(0, memory_order_relaxed);
+      }
+  }
+
+  /** Returns true and fills `out` if the key is present. */
+  bool probe(uint64_t key, TTEntry &out) const {
+    const Bucket &bucket = buckets[key & mask];
+    for (auto &slot : bucket.slots) {
+      uint64_t data = slot.data.load(memory_order_relaxed);
+      uint64_t check = slot.check.load(memory_order_relaxed);
+      if ((check ^ data) == key && data != 0) {
+        out = unpack(data);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void store(uint64_t key, const TTEntry &entry) {
+    Bucket &bucket = buckets[key & mask];
+    Slot* victim = nullptr;
+    int victimWorth = 0;
+
+    for (auto &slot : bucket.slots) {
+      uint64_t data = slot.data.load(memory_order_relaxed);
+      uint64_t check = slot.check.load(memory_order_relaxed);
+
+      if (data == 0 || (check ^ data) == key) {
+        victim = &slot;
+        break;
+      }
+
+      int age = (generation - generationOf(data)) & 31;
+      int worth = depthOf(data) - 8 * age;
+      if (!victim || worth < victimWorth) {
+        victim = &slot;
+        victimWorth = worth;
+      }
+    }
+
+    uint64_t data = pack(entry, generation);
+    victim->data.store(data, memory_order_relaxed);
+    victim->check.store(key ^ data, memory_order_relaxed);
+  }
+};
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <condition_variable>
+#include <unistd.h>
+
+using namespace std;
+
+/** Guarantees an answer every turn. The turn's clock starts when its first input is
+ * read. The bot then writes a cheap fallback command into its CommandWriter and arms
+ * the watchdog with it, before any expensive thinking. If finish() hasn't been called
+ * by the deadline, a background thread writes the fallback itself, and whatever the bot
+ * sends later that turn is discarded instead.
+ *
+ *   cin >> ...;                            // the turn's first read; blocks until it arrives
+ *   watchdog.startTurn();
+ *   // read the rest; out << fallback...;
+ *   watchdog.arm(out, TURN_TIMEOUT_MS);    // deadline is startTurn() + TURN_TIMEOUT_MS
+ *   // expensive search: out.clear() and write something better
+ *   watchdog.finish(out);
+ *
+ * Needs CommandWriter pasted above it. */
+class Watchdog {
+  using Clock = chrono::steady_clock;
+
+  mutex lock;
+  condition_variable wake;
+  char fallback[1024];
+  int fallbackLength = 0;
+  Clock::time_point turnStart = Clock::now();
+  Clock::time_point deadline;
+  bool armed = false;
+  bool stopping = false;
+  atomic<bool> answered {true};   // Whoever flips this first owns the turn's output
+  thread worker;                  // Last, so it starts after everything above is ready
+
+  void run() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+      if (!armed) {
+        wake.wait(guard);
+        continue;
+      }
+
+      if (wake.wait_until(guard, deadline) != cv_status::timeout || !armed)
+        continue;
+
+      armed = false;
+      if (!answered.exchange(true)) {
+        int written = 0;
+        while (written < fallbackLength) {
+          int n = write(STDOUT_FILENO, fallback + written, fallbackLength - written);
+          if (n <= 0)
+            break;
+          written += n;
+        }
+        cerr << "Watchdog: turn overran; sent fallback" << endl;
+      }
+    }
+  }
+
+public:
+  Watchdog() : worker(&Watchdog::run, this) { }
+
+  ~Watchdog() {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+  }
+
+  /** Starts the turn's clock. Call it straight after the turn's first input is read,
+   * since the referee's time limit runs from when it sent that input. */
+  void startTurn() {
+    turnStart = Clock::now();
+  }
+
+  /** Copies out's pending commands as this turn's fallback, to be sent ms after the
+   * turn started. Call it once the fallback is written, before anything expensive. */
+  void arm(const CommandWriter &out, double ms) {
+    {
+      lock_guard<mutex> guard(lock);
+      fallbackLength = min<int>(out.size(), sizeof(fallback));
+      memcpy(fallback, out.data(), fallbackLength);
+      deadline = turnStart + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms));
+      armed = true;
+      answered = false;
+    }
+    wake.notify_one();
+  }
+
+  /** Sends out's commands, unless the watchdog beat us to it this turn, in which case
+   * they're discarded. Returns true if out was the answer that got sent. */
+  bool finish(CommandWriter &out) {
+    bool late = answered.exchange(true);
+    {
+      lock_guard<mutex> guard(lock);
+      armed = false;
+    }
+    wake.notify_one();
+
+    if (late) {
+      out.clear();
+      return false;
+    }
+    out.flush();
+    return true;
+  }
+};
@@ -0,0 +1,207 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Regression bench
+
+Compiles one bot into this driver with its main() renamed, then replays recorded turn
+inputs into it in-process, many times each, and times every replay. run.sh builds each
+bot this way and runs it over its inputs in bench/inputs/<bot>/:
+
+  g++ -std=c++17 -O2 -pthread -DBOT='"../code-vs-zombies/code-vs-zombies.cpp"' bench.cpp
+  ./a.out --bot zombies --baseline baseline.jsonl inputs/zombies/*.txt
+
+Prints one JSON object per input: the minimum and median replay time in milliseconds,
+and, given a baseline, that input's committed minimum and a status of "ok", "slower"
+(minimum beyond the threshold above the baseline's), "new" or "error". Exits 1 if any
+input came out slower or errored. Minimums are compared because they're far steadier
+between runs than medians; the fastest replay is the one least disturbed by the machine.
+
+The bots loop forever reading stdin, so the replay buffer ends a run by throwing from
+the read that runs past the recording. The bot's stdout is sent to /dev/null and its
+cerr discarded; formatting the debug output still counts toward its time, as it does
+in the arena. A recording is only a fixed sequence of inputs, so a bot that has since
+changed its moves still gets the same states, just no longer ones it led to.
+
+*/
+
+namespace Bench {
+  struct EndOfInput { };
+
+  /** Serves a recording to cin; reading past its end throws EndOfInput. */
+  class ReplayBuffer : public std::streambuf {
+    std::string text;
+
+  protected:
+    int_type underflow() override {
+      throw EndOfInput();
+    }
+
+  public:
+    ReplayBuffer(const std::string &text) : text(text) { }
+
+    void rewind() {
+      setg(&text[0], &text[0], &text[0] + text.size());
+    }
+  };
+
+  /** Swallows everything written to it. */
+  class NullBuffer : public std::streambuf {
+  protected:
+    int_type overflow(int_type c) override {
+      return traits_type::not_eof(c);
+    }
+  };
+}
+
+#define main bot_main
+#include BOT
+#undef main
+
+namespace Bench {
+  struct Result {
+    string input;
+    double minMs = 0;
+    double medianMs = 0;
+    double baselineMs = -1;     // Baseline min_ms; -1 if the baseline has no such input
+    bool failed = false;
+  };
+
+  string readFile(const string &path) {
+    ifstream file(path);
+    stringstream text;
+    text << file.rdbuf();
+    return text.str();
+  }
+
+  /** Reads the min_ms of each of the bot's inputs from a file of lines as printed
+   * by this driver. Only the fields this driver writes are understood. */
+  vector<pair<string, double>> readBaseline(const string &path, const string &bot) {
+    vector<pair<string, double>> minimums;
+    ifstream file(path);
+    string line;
+
+    auto field = [&line](const string &name) {
+      size_t at = line.find("\"" + name + "\":");
+      if (at == string::npos)
+        return string();
+      at += name.size() + 3;
+      if (line[at] == '"')
+        return line.substr(at + 1, line.find('"', at + 1) - at - 1);
+      return line.substr(at, line.find_first_of(",}", at) - at);
+    };
+
+    while (getline(file, line))
+      if (field("bot") == bot && !field("min_ms").empty())
+        minimums.push_back({field("input"), atof(field("min_ms").c_str())});
+    return minimums;
+  }
+
+  /** Runs the bot over the recording `iterations` times; returns each run's duration. */
+  vector<double> replay(const string &recording, int iterations, bool &failed) {
+    using Clock = chrono::steady_clock;
+
+    ReplayBuffer input(recording);
+    NullBuffer discard;
+    streambuf* stdinBuffer = cin.rdbuf(&input);
+    streambuf* stderrBuffer = cerr.rdbuf(&discard);
+    ios::iostate stdinExceptions = cin.exceptions();
+
+    cout.flush();
+    int stdoutFd = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+
+    vector<double> times;
+    for (int i = 0; i < iterations && !failed; ++i) {
+      input.rewind();
+      cin.clear();
+      cin.exceptions(ios::badbit);   // So EndOfInput escapes the stream to us
+
+      auto start = Clock::now();
+      try {
+        bot_main();
+      }
+      catch (const EndOfInput &) { }
+      catch (...) {
+        failed = true;
+      }
+      times.push_back(chrono::duration<double, milli>(Clock::now() - start).count());
+    }
+
+    cout.flush();
+    dup2(stdoutFd, STDOUT_FILENO);
+    close(stdoutFd);
+    cin.clear();
+    cin.exceptions(stdinExceptions);
+    cin.rdbuf(stdinBuffer);
+    cerr.rdbuf(stderrBuffer);
+    return times;
+  }
+}
+
+int main(int argc, char** argv) {
+  string bot = "bot";
+  string baselinePath;
+  int iterations = 20;
+  double threshold = 0.25;
+  vector<string> inputs;
+
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg == "--bot" && i + 1 < argc)
+      bot = argv[++i];
+    else if (arg == "--baseline" && i + 1 < argc)
+      baselinePath = argv[++i];
+    else if (arg == "--iterations" && i + 1 < argc)
+      iterations = max(1, atoi(argv[++i]));
+    else if (arg == "--threshold" && i + 1 < argc)
+      threshold = atof(argv[++i]);
+    else
+      inputs.push_back(arg);
+  }
+
+  vector<pair<string, double>> baseline;
+  if (!baselinePath.empty())
+    baseline = Bench::readBaseline(baselinePath, bot);
+
+  bool regressed = false;
+  for (const string &path : inputs) {
+    Bench::Result result;
+    result.input = path.substr(path.find_last_of('/') + 1);
+
+    vector<double> times = Bench::replay(Bench::readFile(path), iterations, result.failed);
+    sort(times.begin(), times.end());
+    result.minMs = times.front();
+    result.medianMs = times[times.size() / 2];
+
+    for (auto &[input, minMs] : baseline)
+      if (input == result.input)
+        result.baselineMs = minMs;
+
+    const char* status = "new";
+    if (result.failed)
+      status = "error";
+    else if (result.baselineMs >= 0)
+      status = (result.minMs > result.baselineMs * (1 + threshold)) ? "slower" : "ok";
+    regressed |= result.failed || string(status) == "slower";
+
+    printf("{\"bot\":\"%s\",\"input\":\"%s\",\"iterations\":%d,\"min_ms\":%.3f,\"median_ms\":%.3f",
+      bot.c_str(), result.input.c_str(), int(times.size()), result.minMs, result.medianMs);
+    if (result.baselineMs >= 0)
+      printf(",\"baseline_ms\":%.3f", result.baselineMs);
+    printf(",\"status\":\"%s\"}\n", status);
+    fflush(stdout);
+  }
+
+  return regressed ? 1 : 0;
+}
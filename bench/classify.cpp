@@ -0,0 +1,261 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include "../0 - common/cpp/Point.cpp"
+#include "../0 - common/cpp/PointBatch.cpp"
+#include "../0 - common/cpp/Random.cpp"
+
+/* Batch classifier check
+
+Runs the Classify kernels from PointBatch.cpp against the scalar Point code they stand in
+for, and reports any disagreement along with the throughput of both:
+
+  g++ -std=c++17 -O2 -o classify bench/classify.cpp && ./classify [rounds]
+
+Every round draws a line, a jump and a random convex polygon, winding either way, then
+classifies random points plus points exactly on the line, on the jump's bisector, and on
+the polygon's corners and edges, where the sign tests have to come out as ties. Rounds
+alternate between board-sized coordinates and ones up to 2^24, whose differences and
+squared distances stay exact in doubles, as the kernels need. Exits 1 on any mismatch.
+
+*/
+
+namespace Check {
+  int sign(double v) {
+    return (v > 0) - (v < 0);
+  }
+
+  // The scalar versions, one point at a time, written with Point as a bot would
+
+  int side(const Point &A, const Point &B, const Point &p) {
+    return sign((B - A).crossZ(p - A));
+  }
+
+  int clue(const Point &from, const Point &to, const Point &p) {
+    return sign(p.distanceTo(from) - p.distanceTo(to));
+  }
+
+  bool insideConvex(const vector<Point> &polygon, const Point &p) {
+    const int sides = polygon.size();
+    bool left = true, right = true;
+    for (int s = 0; s < sides; ++s) {
+      double turn = side(polygon[s], polygon[(s + 1) % sides], p);
+      left &= turn >= 0;
+      right &= turn <= 0;
+    }
+    return left || right;
+  }
+
+  struct Tally {
+    const char* kernel;
+    long count = 0;
+    long ties = 0;          // Points exactly on a line, bisector or edge
+    long mismatches = 0;
+    Point worst;
+
+    void add(int batch, int scalar, bool tie, const Point &p) {
+      ++count;
+      ties += tie;
+      if (batch != scalar) {
+        ++mismatches;
+        worst = p;
+      }
+    }
+
+    bool report() const {
+      printf("  %-14s %9ld points  %8ld ties  %ld mismatches", kernel, count, ties, mismatches);
+      if (mismatches)
+        printf("  e.g. (%g, %g)", worst.x, worst.y);
+      printf("\n");
+      return mismatches == 0;
+    }
+  };
+
+  /** The convex hull of the points, counter-clockwise, by monotone chain. */
+  vector<Point> hull(vector<Point> points) {
+    sort(points.begin(), points.end(), [](const Point &a, const Point &b) {
+      return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+    const int n = points.size();
+    vector<Point> corners(2 * n);
+    int k = 0;
+    for (int i = 0; i < n; ++i) {
+      while (k >= 2 && (corners[k-1] - corners[k-2]).crossZ(points[i] - corners[k-2]) <= 0)
+        --k;
+      corners[k++] = points[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; --i) {
+      while (k >= lower && (corners[k-1] - corners[k-2]).crossZ(points[i] - corners[k-2]) <= 0)
+        --k;
+      corners[k++] = points[i];
+    }
+    corners.resize(max(k - 1, 0));
+    return corners;
+  }
+
+  struct Round {
+    Point A, B;             // The line for side()
+    Point from, to;         // The jump for clue()
+    vector<Point> polygon;
+    PointBatch points;
+  };
+
+  /** A round within [-size, size) on both axes. */
+  Round draw(Rng &rng, int size, int randomCount) {
+    auto anywhere = [&rng, size]() { return Point(rng.range(-size, size - 1), rng.range(-size, size - 1)); };
+    Round round;
+
+    do {
+      round.A = anywhere();
+      round.B = anywhere();
+    } while (round.A == round.B);
+
+    // An even step from `from` to `to` puts the bisector through lattice points
+    round.from = anywhere();
+    int reach = max(1, size / 4);
+    do {
+      round.to = round.from + Point(2 * rng.range(-reach, reach), 2 * rng.range(-reach, reach));
+    } while (round.to == round.from);
+
+    do {
+      vector<Point> cloud;
+      int corners = rng.range(3, 12);
+      for (int i = 0; i < corners; ++i)
+        cloud.push_back(anywhere());
+      round.polygon = hull(cloud);
+    } while (round.polygon.size() < 3);
+    if (rng.chance(0.5))
+      reverse(round.polygon.begin(), round.polygon.end());
+
+    PointBatch &points = round.points;
+    for (int i = 0; i < randomCount; ++i)
+      points.push_back(anywhere());
+
+    Point along = round.B - round.A;
+    for (int t = -3; t <= 3; ++t)
+      points.push_back(round.A + along * t);
+
+    Point mid = (round.from + round.to) / 2;
+    Point across = Point(round.from.y - round.to.y, round.to.x - round.from.x) / 2;
+    for (int t = -3; t <= 3; ++t)
+      points.push_back(mid + across * t);
+
+    const int sides = round.polygon.size();
+    for (int s = 0; s < sides; ++s) {
+      const Point &corner = round.polygon[s];
+      const Point &next = round.polygon[(s + 1) % sides];
+      points.push_back(corner);
+      Point halfway = (corner + next) / 2;
+      if (halfway.x == floor(halfway.x) && halfway.y == floor(halfway.y))
+        points.push_back(halfway);
+    }
+    return round;
+  }
+}
+
+int main(int argc, char** argv) {
+  using namespace Check;
+  const int rounds = (argc > 1) ? max(1, atoi(argv[1])) : 4000;
+  Rng rng(0x9E3779B97F4A7C15ull);   // Fixed, so every run checks the same rounds
+
+  Tally sides {"side"}, clues {"clue"}, insides {"insideConvex"};
+  vector<int8_t> signs;
+  vector<uint8_t> flags;
+
+  for (int r = 0; r < rounds; ++r) {
+    int size = (r % 2) ? (1 << 24) : 10000;
+    Round round = draw(rng, size, 256);
+    const PointBatch &points = round.points;
+    signs.resize(points.size());
+    flags.resize(points.size());
+
+    Classify::side(round.A, round.B, points, signs.data());
+    for (int i = 0; i < points.size(); ++i) {
+      Point p(points.xs[i], points.ys[i]);
+      int scalar = side(round.A, round.B, p);
+      sides.add(signs[i], scalar, scalar == 0, p);
+    }
+
+    Classify::clue(round.from, round.to, points, signs.data());
+    for (int i = 0; i < points.size(); ++i) {
+      Point p(points.xs[i], points.ys[i]);
+      int scalar = clue(round.from, round.to, p);
+      clues.add(signs[i], scalar, scalar == 0, p);
+    }
+
+    Classify::insideConvex(round.polygon, points, flags.data());
+    for (int i = 0; i < points.size(); ++i) {
+      Point p(points.xs[i], points.ys[i]);
+      const int sides = round.polygon.size();
+      bool inside = insideConvex(round.polygon, p), onEdge = false;
+      for (int s = 0; s < sides; ++s)
+        onEdge |= side(round.polygon[s], round.polygon[(s + 1) % sides], p) == 0;
+      insides.add(flags[i], inside, inside && onEdge, p);
+    }
+  }
+
+  printf("Classify kernels against the scalar Point tests, %d rounds:\n", rounds);
+  bool ok = true;
+  ok &= sides.report();
+  ok &= clues.report();
+  ok &= insides.report();
+
+  // Throughput over one board-sized round's worth of points; the sums keep the work live
+  using Clock = chrono::steady_clock;
+  Round round = draw(rng, 10000, 1 << 16);
+  const PointBatch &points = round.points;
+  const int n = points.size();
+  vector<Point> scalarPoints;
+  for (int i = 0; i < n; ++i)
+    scalarPoints.push_back(Point(points.xs[i], points.ys[i]));
+  signs.resize(n);
+  flags.resize(n);
+  const int passes = 50;
+
+  auto time = [&](auto classify, auto read) {
+    long sum = 0;
+    auto start = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+      classify();
+      for (int i = 0; i < n; i += 97)
+        sum += read(i);
+    }
+    double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+    return make_pair(ns / (double(passes) * n), sum);
+  };
+  auto readSign = [&signs](int i) { return long(signs[i]); };
+  auto readFlag = [&flags](int i) { return long(flags[i]); };
+
+  auto report = [](const char* kernel, pair<double, long> batch, pair<double, long> scalar) {
+    printf("  %-14s batch %.2f ns, scalar %.2f ns per point (checksums %ld, %ld)\n",
+      kernel, batch.first, scalar.first, batch.second, scalar.second);
+  };
+
+  printf("throughput, %d points:\n", n);
+  report("side",
+    time([&] { Classify::side(round.A, round.B, points, signs.data()); }, readSign),
+    time([&] {
+      for (int i = 0; i < n; ++i)
+        signs[i] = side(round.A, round.B, scalarPoints[i]);
+    }, readSign));
+  report("clue",
+    time([&] { Classify::clue(round.from, round.to, points, signs.data()); }, readSign),
+    time([&] {
+      for (int i = 0; i < n; ++i)
+        signs[i] = clue(round.from, round.to, scalarPoints[i]);
+    }, readSign));
+  report("insideConvex",
+    time([&] { Classify::insideConvex(round.polygon, points, flags.data()); }, readFlag),
+    time([&] {
+      for (int i = 0; i < n; ++i)
+        flags[i] = insideConvex(round.polygon, scalarPoints[i]);
+    }, readFlag));
+
+  return ok ? 0 : 1;
+}
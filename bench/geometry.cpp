@@ -0,0 +1,166 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include "../0 - common/cpp/Point.cpp"
+#include "../0 - common/cpp/Random.cpp"
+
+/* Geometry accuracy check
+
+Runs Point::fastUnitVector against the exact normalisation, x / hypot(x, y), over a sweep
+of vectors, and reports each group's worst and mean error (the distance between the
+two results) along with the throughput of both:
+
+  g++ -std=c++17 -O2 -o geometry bench/geometry.cpp && ./geometry [random count]
+
+The groups are random vectors of mixed sign, both axes in both directions, exact and
+near diagonals, lattice points around the origin, and tiny and huge magnitudes. The
+zero vector must come back as zero. Exits 1 if any result isn't finite or any error
+exceeds 0.05; the approximation's worst case is 0.0493, about 20° off an axis.
+Inputs are normal doubles; subnormals overflow the approximation's 1 / max(|x|, |y|).
+
+*/
+
+namespace Geometry {
+  const double ERROR_BOUND = 0.05;
+
+  struct Errors {
+    string group;
+    int count = 0;
+    double max = 0;
+    double sum = 0;
+    Point worst;
+    bool finite = true;
+
+    void add(const Point &v) {
+      double length = hypot(v.x, v.y);
+      Point exact(v.x / length, v.y / length);
+      Point fast = v.fastUnitVector();
+      if (!isfinite(fast.x) || !isfinite(fast.y)) {
+        finite = false;
+        worst = v;
+        return;
+      }
+      double error = hypot(fast.x - exact.x, fast.y - exact.y);
+      sum += error;
+      ++count;
+      if (error > max) {
+        max = error;
+        worst = v;
+      }
+    }
+
+    bool report() const {
+      bool ok = finite && max <= ERROR_BOUND;
+      printf("  %-12s %9d  max %.5f  mean %.5f  worst (%g, %g)%s\n",
+        group.c_str(), count, max, count ? sum / count : 0.0, worst.x, worst.y,
+        ok ? "" : (finite ? "  OVER BOUND" : "  NOT FINITE"));
+      return ok;
+    }
+  };
+
+  /** Draws from the bots' Rng, with a fixed seed so every run sweeps the same vectors. */
+  struct Sweep {
+    Rng rng {0x9E3779B97F4A7C15ull};
+
+    double unit() {   // [-1, 1)
+      return 2 * rng.unit() - 1;
+    }
+  };
+}
+
+int main(int argc, char** argv) {
+  using namespace Geometry;
+  const int randomCount = (argc > 1) ? max(1, atoi(argv[1])) : 1000000;
+  Sweep sweep;
+  deque<Errors> groups;   // Stable references as groups are added
+  auto group = [&groups](const char* name) -> Errors& {
+    groups.push_back(Errors());
+    groups.back().group = name;
+    return groups.back();
+  };
+
+  Errors &random = group("random");
+  for (int i = 0; i < randomCount; ++i) {
+    Point v(sweep.unit() * 20000, sweep.unit() * 20000);
+    if (v.x != 0 || v.y != 0)
+      random.add(v);
+  }
+
+  Errors &axes = group("axes");
+  for (double m = 1e-300; m < 1e300; m *= 7.3) {
+    axes.add(Point(m, 0));
+    axes.add(Point(-m, 0));
+    axes.add(Point(0, m));
+    axes.add(Point(0, -m));
+  }
+
+  Errors &diagonals = group("diagonals");
+  for (int i = 1; i <= 20000; ++i) {
+    double nudge = 1 + sweep.unit() * 1e-3;
+    for (int sx = -1; sx <= 1; sx += 2)
+      for (int sy = -1; sy <= 1; sy += 2) {
+        diagonals.add(Point(sx * i, sy * i));
+        diagonals.add(Point(sx * i * nudge, sy * i));
+      }
+  }
+
+  Errors &lattice = group("lattice");
+  for (int x = -200; x <= 200; ++x)
+    for (int y = -200; y <= 200; ++y)
+      if (x != 0 || y != 0)
+        lattice.add(Point(x, y));
+
+  Errors &tiny = group("tiny");
+  Errors &huge = group("huge");
+  for (int i = 0; i < 100000; ++i) {
+    double a = sweep.unit(), b = sweep.unit();
+    if (a == 0 && b == 0)
+      continue;
+    tiny.add(Point(a * 1e-300, b * 1e-300));
+    huge.add(Point(a * 1e300, b * 1e300));
+  }
+
+  printf("fastUnitVector against x / hypot(x, y):\n");
+  bool ok = true;
+  for (const Errors &errors : groups)
+    ok &= errors.report();
+
+  Point zero = Point(0, 0).fastUnitVector();
+  bool zeroOk = (zero.x == 0 && zero.y == 0);
+  printf("  %-12s %s\n", "zero", zeroOk ? "(0, 0)" : "NOT ZERO");
+  ok &= zeroOk;
+
+  // Throughput, over the lattice so both see the same vectors; the sums keep the work live
+  using Clock = chrono::steady_clock;
+  vector<Point> vectors;
+  for (int x = -300; x <= 300; ++x)
+    for (int y = -300; y <= 300; ++y)
+      if (x != 0 || y != 0)
+        vectors.push_back(Point(x, y));
+  const int passes = 20;
+
+  auto time = [&](auto normalise) {
+    double sum = 0;
+    auto start = Clock::now();
+    for (int p = 0; p < passes; ++p)
+      for (const Point &v : vectors) {
+        Point u = normalise(v);
+        sum += u.x + u.y;
+      }
+    double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+    return make_pair(ns / (double(passes) * vectors.size()), sum);
+  };
+  auto fast = time([](const Point &v) { return v.fastUnitVector(); });
+  auto exact = time([](const Point &v) { return v.unitVector(); });
+  printf("throughput: fastUnitVector %.2f ns, unitVector %.2f ns per vector (checksums %g, %g)\n",
+    fast.first, exact.first, fast.second, exact.second);
+
+  return ok ? 0 : 1;
+}
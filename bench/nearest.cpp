@@ -0,0 +1,133 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+
+/* NearestHumans check
+
+Compiles the zombies bot with its main() renamed, as bench.cpp does, and drives its
+NearestHumans index directly:
+
+  g++ -std=c++17 -O2 -pthread -o nearest bench/nearest.cpp && ./nearest
+
+First, a zombie walking straight at its nearest human must not trigger a rescan after
+the first one, and the death of that human must. Then random games, with zombies
+stepping at their nearest human as the referee moves them and humans dying when
+reached, compare every answer with a plain scan and report how many calls rescanned.
+Exits 1 on any mismatch or on a rescan the straight walk shouldn't need.
+
+*/
+
+#define main bot_main
+#include "../code-vs-zombies/code-vs-zombies.cpp"
+#undef main
+
+#include "../0 - common/cpp/Random.cpp"
+
+namespace Nearest {
+  bool failed = false;
+
+  void check(bool ok, const char* what) {
+    if (!ok) {
+      printf("  FAILED: %s\n", what);
+      failed = true;
+    }
+  }
+
+  Entity entity(int id, int x, int y) {
+    Entity e;
+    e.id = id;
+    e.location = Point(x, y);
+    return e;
+  }
+
+  /** What nearest() must agree with: the first survivor at the least distance. */
+  int scan(const Entity &zombie, const EntityList &survivors) {
+    int best = -1;
+    double closest = MAX_INT;
+    for (int i = 0; i < survivors.size(); ++i) {
+      double dist = zombie.location.distanceTo(survivors[i].location);
+      if (dist < closest) {
+        closest = dist;
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  void straightWalk() {
+    NearestHumans nearest;
+    EntityList survivors;
+    survivors.push_back(entity(0, 8000, 4500));
+    survivors.push_back(entity(1, 1000, 1000));
+    survivors.push_back(entity(2, 15000, 8500));
+    Entity zombie = entity(0, 13000, 2000);
+
+    int turns = 0;
+    while (zombie.location.x != 8000 || zombie.location.y != 4500) {
+      nearest.update(survivors);
+      check(nearest.nearest(zombie) == 0, "straight walk: wrong nearest human");
+      zombie.location = stepToward(zombie.location, survivors[0].location, ZOMBIE_SPEED);
+      ++turns;
+    }
+    printf("straight walk: %d turns, %d rescans\n", turns, nearest.rescans);
+    check(nearest.rescans == 1, "straight walk: rescanned after the first turn");
+
+    survivors.erase(survivors.begin());
+    nearest.update(survivors);
+    check(nearest.nearest(zombie) == scan(zombie, survivors), "after a death: wrong nearest human");
+    check(nearest.rescans == 2, "after a death: didn't rescan");
+  }
+
+  /** Draws from the bots' Rng, with a fixed seed so every run plays the same games. */
+  struct Dice {
+    Rng rng {0x9E3779B97F4A7C15ull};
+
+    int below(int n) {
+      return rng.bounded(n);
+    }
+  };
+
+  void randomGames(int games) {
+    Dice dice;
+    long calls = 0, rescans = 0, mismatches = 0;
+
+    for (int game = 0; game < games; ++game) {
+      NearestHumans nearest;
+      EntityList survivors, zombies;
+      int humanCount = 1 + dice.below(MAX_ENTITIES - 1);
+      int zombieCount = 1 + dice.below(MAX_ENTITIES - 1);
+      for (int i = 0; i < humanCount; ++i)
+        survivors.push_back(entity(i, dice.below(BOARD_WIDTH), dice.below(BOARD_HEIGHT)));
+      for (int i = 0; i < zombieCount; ++i)
+        zombies.push_back(entity(i, dice.below(BOARD_WIDTH), dice.below(BOARD_HEIGHT)));
+
+      for (int turn = 0; turn < 60 && survivors.size() > 0; ++turn) {
+        nearest.update(survivors);
+        for (auto &zombie : zombies) {
+          int index = nearest.nearest(zombie);
+          mismatches += index != scan(zombie, survivors);
+          ++calls;
+          zombie.location = stepToward(zombie.location, survivors[index].location, ZOMBIE_SPEED);
+        }
+
+        EntityList living;
+        for (auto &survivor : survivors)
+          if (none_of(zombies.begin(), zombies.end(), [&survivor](const Entity &zombie) {
+              return zombie.location.x == survivor.location.x && zombie.location.y == survivor.location.y; }))
+            living.push_back(survivor);
+        survivors = living;
+      }
+      rescans += nearest.rescans;
+    }
+
+    printf("random games: %d games, %ld calls, %ld rescans (%.1f%%), %ld mismatches\n",
+      games, calls, rescans, 100.0 * rescans / calls, mismatches);
+    check(mismatches == 0, "random games: nearest() disagreed with a scan");
+  }
+}
+
+int main() {
+  Nearest::straightWalk();
+  Nearest::randomGames(200);
+  return Nearest::failed ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Builds each bot into the bench driver and replays its recorded inputs.
+#
+#   bench/run.sh              compare against baseline.jsonl; exits 1 on a slowdown
+#   bench/run.sh --update     rewrite baseline.jsonl from this machine's timings
+#
+# ITERATIONS and THRESHOLD in the environment override the defaults below. Timings
+# only compare on the machine that wrote the baseline, so refresh it with --update
+# before starting on a new machine. The threshold is loose because a shared machine
+# can shift a whole process's speed by a third between runs.
+
+cd "$(dirname "$0")" || exit 1
+
+ITERATIONS=${ITERATIONS:-20}
+THRESHOLD=${THRESHOLD:-0.25}
+BUILD=build
+mkdir -p "$BUILD"
+
+update=0
+[ "$1" = "--update" ] && update=1
+
+status=0
+results="$BUILD/results.jsonl"
+: > "$results"
+
+bench() {
+  name=$1
+  source=$2
+
+  g++ -std=c++17 -O2 -pthread -DBOT="\"$source\"" -o "$BUILD/$name" bench.cpp || { status=1; return; }
+
+  if [ $update = 1 ]; then
+    "./$BUILD/$name" --bot "$name" --iterations "$ITERATIONS" inputs/"$name"/*.txt
+  else
+    "./$BUILD/$name" --bot "$name" --iterations "$ITERATIONS" --threshold "$THRESHOLD" \
+      --baseline baseline.jsonl inputs/"$name"/*.txt
+  fi >> "$results" || status=1
+}
+
+bench zombies ../code-vs-zombies/code-vs-zombies.cpp
+bench spider "../spider-attack(spring-2022)/spring-challenge-2022.cpp"
+bench shadows ../shadows-of-the-knight/ep2/solution.cpp
+bench unknown-rules ../unknown-rules/solution.cpp
+
+cat "$results"
+[ $update = 1 ] && cp "$results" baseline.jsonl
+exit $status
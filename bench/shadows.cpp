@@ -0,0 +1,153 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../0 - common/cpp/Random.cpp"
+
+/* Shadows of the Knight ep2 referee
+
+Plays a compiled ep2 bot over a fixed list of games, as the referee would: it sends the
+building, the turn budget, the start and UNKNOWN, then answers each jump with WARMER,
+COLDER or SAME until the bot lands on the bomb or runs out of turns.
+
+  g++ -std=c++17 -O2 -pthread -o ep2 shadows-of-the-knight/ep2/solution.cpp
+  g++ -std=c++17 -O2 -o referee bench/shadows.cpp && ./referee ./ep2
+
+The first games put the bomb on the bisector of the bot's early jumps in one- and
+three-cell-wide buildings, where a search that keeps the bisector's cells after WARMER
+or COLDER bounces between two jumps forever. The rest are seeded random buildings,
+thin and small, each with a budget of 2·log2(cells) + 2 turns. Prints every game that
+fails and a total; exits 1 if any did.
+
+*/
+
+namespace Referee {
+  using namespace std;
+
+  struct Game {
+    int width, height;
+    int turns;
+    int startX, startY;
+    int bombX, bombY;
+  };
+
+  /** Runs the bot on one game; returns the turn it found the bomb on, or 0 if it didn't. */
+  int play(const char* bot, const Game &game) {
+    int toBot[2], fromBot[2];
+    if (pipe(toBot) != 0 || pipe(fromBot) != 0)
+      return 0;
+
+    pid_t child = fork();
+    if (child == 0) {
+      dup2(toBot[0], STDIN_FILENO);
+      dup2(fromBot[1], STDOUT_FILENO);
+      FILE* quiet = freopen("/dev/null", "w", stderr);
+      (void) quiet;
+      close(toBot[1]);
+      close(fromBot[0]);
+      execl(bot, bot, (char*) nullptr);
+      _exit(127);
+    }
+    close(toBot[0]);
+    close(fromBot[1]);
+    FILE* in = fdopen(toBot[1], "w");
+    FILE* out = fdopen(fromBot[0], "r");
+
+    fprintf(in, "%d %d\n%d\n%d %d\nUNKNOWN\n", game.width, game.height, game.turns, game.startX, game.startY);
+    fflush(in);
+
+    int found = 0;
+    long x = game.startX, y = game.startY;
+    for (int turn = 1; turn <= game.turns; ++turn) {
+      long nextX, nextY;
+      if (fscanf(out, "%ld %ld", &nextX, &nextY) != 2)
+        break;
+      if (nextX < 0 || nextX >= game.width || nextY < 0 || nextY >= game.height)
+        break;
+      if (nextX == game.bombX && nextY == game.bombY) {
+        found = turn;
+        break;
+      }
+
+      long before = (x - game.bombX) * (x - game.bombX) + (y - game.bombY) * (y - game.bombY);
+      long after = (nextX - game.bombX) * (nextX - game.bombX) + (nextY - game.bombY) * (nextY - game.bombY);
+      fprintf(in, "%s\n", after < before ? "WARMER" : after > before ? "COLDER" : "SAME");
+      fflush(in);
+      x = nextX;
+      y = nextY;
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    fclose(in);
+    fclose(out);
+    return found;
+  }
+
+  /** Draws from the bots' Rng, with a fixed seed so every run plays the same games. */
+  struct Dice {
+    Rng rng {0x9E3779B97F4A7C15ull};
+
+    int below(int n) {
+      return rng.bounded(n);
+    }
+  };
+
+  int budget(int width, int height) {
+    return 2 * int(ceil(log2(double(width) * height))) + 2;
+  }
+
+  vector<Game> games() {
+    vector<Game> list = {
+      {1, 100, budget(1, 100), 0, 54, 0, 66},
+      {100, 1, budget(100, 1), 54, 0, 66, 0},
+      {3, 40, budget(3, 40), 1, 20, 1, 30},
+      {3, 40, budget(3, 40), 0, 10, 2, 26},
+      {100, 3, budget(100, 3), 54, 1, 66, 1},
+      {100, 3, budget(100, 3), 10, 0, 40, 2},
+    };
+
+    Dice dice;
+    while (list.size() < 300) {
+      int width, height;
+      switch (dice.below(3)) {
+        case 0:  width = 1 + dice.below(3); height = 10 + dice.below(191); break;
+        case 1:  width = 10 + dice.below(191); height = 1 + dice.below(3); break;
+        default: width = 2 + dice.below(59); height = 2 + dice.below(59); break;
+      }
+      Game game {width, height, budget(width, height),
+        dice.below(width), dice.below(height), dice.below(width), dice.below(height)};
+      if (game.startX != game.bombX || game.startY != game.bombY)
+        list.push_back(game);
+    }
+    return list;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <ep2 binary>\n", argv[0]);
+    return 2;
+  }
+  signal(SIGPIPE, SIG_IGN);     // A bot that dies mid-game fails it rather than ending the run
+
+  int failed = 0, turns = 0;
+  std::vector<Referee::Game> games = Referee::games();
+  for (auto &game : games) {
+    int found = Referee::play(argv[1], game);
+    turns += found;
+    if (!found) {
+      ++failed;
+      printf("FAILED %dx%d, %d turns, start (%d, %d), bomb (%d, %d)\n", game.width, game.height,
+        game.turns, game.startX, game.startY, game.bombX, game.bombY);
+    }
+  }
+  printf("%d of %d games found, in %d turns\n", int(games.size()) - failed, int(games.size()), turns);
+  return failed ? 1 : 0;
+}
@@ -5,6 +5,22 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <new>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <memory>
+#include <cstdint>
+
+#include <cstring>
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 
 using namespace std;
 
@@ -14,6 +30,12 @@ const int MAX_INT = pow(2,31)-1;
 const int ASH_SPEED = 1000;
 const int SHOOT_DISTANCE = 2000;
 const int ZOMBIE_SPEED = 400;
+const int TURN_TIMEOUT_MS = 90;  // Of the 100ms the referee allows
+const int MAX_ENTITIES = 100;   // Per kind; the game never gives more humans or zombies than this.
+const int BOARD_WIDTH = 16000;
+const int BOARD_HEIGHT = 9000;
+const int ROLLOUT_TURNS = 50;   // How far checkByRollout plays each candidate out
+const int GRID_CANDIDATES = 10; // AshValueGrid cells checkByRollout tries besides triage's pick
 
 /*
 == Here's the firm goal:
@@ -72,6 +94,618 @@ public:
     }
 };
 
+/** Builds a turn's output in a buffer and hands it to the OS with one write() call; no
+ * iostreams, locales or per-line flushes. Integers are formatted two digits at a time
+ * from a lookup table. The buffer grows rather than flushing early, so nothing reaches
+ * stdout before flush(); the Watchdog relies on that to discard a late answer.
+ *
+ *   out << "MOVE " << x << ' ' << y << '\n';
+ *   out.flush();   // once, after the turn's last command
+ *
+ * Don't mix with cout in the same bot; the two buffers would interleave. */
+class CommandWriter {
+    vector<char> buffer = vector<char>(4096);
+    int length = 0;
+
+    void reserve(int n) {
+        if (length + n > int(buffer.size()))
+            buffer.resize(max<size_t>(buffer.size() * 2, length + n));
+    }
+
+public:
+
+    CommandWriter& operator<<(char c) {
+        reserve(1);
+        buffer[length++] = c;
+        return *this;
+    }
+
+    CommandWriter& operator<<(const char* s) {
+        int n = strlen(s);
+        reserve(n);
+        memcpy(buffer.data() + length, s, n);
+        length += n;
+        return *this;
+    }
+
+    CommandWriter& operator<<(const string &s) {
+        reserve(s.size());
+        memcpy(buffer.data() + length, s.data(), s.size());
+        length += s.size();
+        return *this;
+    }
+
+    CommandWriter& operator<<(int n) {
+        static const char digitPairs[] =
+            "00010203040506070809" "10111213141516171819" "20212223242526272829"
+            "30313233343536373839" "40414243444546474849" "50515253545556575859"
+            "60616263646566676869" "70717273747576777879" "80818283848586878889"
+            "90919293949596979899";
+
+        reserve(11);
+        unsigned int u = (n < 0) ? 0u - unsigned(n) : unsigned(n);
+        if (n < 0)
+            buffer[length++] = '-';
+
+        char digits[10];
+        int i = 10;
+        while (u >= 100) {
+            int pair = (u % 100) * 2;
+            u /= 100;
+            digits[--i] = digitPairs[pair + 1];
+            digits[--i] = digitPairs[pair];
+        }
+        if (u >= 10) {
+            digits[--i] = digitPairs[u * 2 + 1];
+            digits[--i] = digitPairs[u * 2];
+        }
+        else
+            digits[--i] = '0' + u;
+
+        memcpy(buffer.data() + length, digits + i, 10 - i);
+        length += 10 - i;
+        return *this;
+    }
+
+    const char* data() const { return buffer.data(); }
+    int size() const { return length; }
+
+    /** Discards everything buffered. */
+    void clear() {
+        length = 0;
+    }
+
+    /** Writes everything buffered to stdout. */
+    void flush() {
+        int written = 0;
+        while (written < length) {
+            int n = write(STDOUT_FILENO, buffer.data() + written, length - written);
+            if (n <= 0)
+                break;
+            written += n;
+        }
+        length = 0;
+    }
+};
+
+/** Guarantees an answer every turn. The turn's clock starts when its first input is
+ * read. The bot then writes a cheap fallback command into its CommandWriter and arms
+ * the watchdog with it, before any expensive thinking. If finish() hasn't been called
+ * by the deadline, a background thread writes the fallback itself, and whatever the bot
+ * sends later that turn is discarded instead.
+ *
+ *   cin >> ...;                            // the turn's first read; blocks until it arrives
+ *   watchdog.startTurn();
+ *   // read the rest; out << fallback...;
+ *   watchdog.arm(out, TURN_TIMEOUT_MS);    // deadline is startTurn() + TURN_TIMEOUT_MS
+ *   // expensive search: out.clear() and write something better
+ *   watchdog.finish(out);
+ *
+ * Needs CommandWriter pasted above it. */
+class Watchdog {
+    using Clock = chrono::steady_clock;
+
+    mutex lock;
+    condition_variable wake;
+    char fallback[1024];
+    int fallbackLength = 0;
+    Clock::time_point turnStart = Clock::now();
+    Clock::time_point deadline;
+    bool armed = false;
+    bool stopping = false;
+    atomic<bool> answered {true};   // Whoever flips this first owns the turn's output
+    thread worker;                  // Last, so it starts after everything above is ready
+
+    void run() {
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            if (!armed) {
+                wake.wait(guard);
+                continue;
+            }
+
+            if (wake.wait_until(guard, deadline) != cv_status::timeout || !armed)
+                continue;
+
+            armed = false;
+            if (!answered.exchange(true)) {
+                int written = 0;
+                while (written < fallbackLength) {
+                    int n = write(STDOUT_FILENO, fallback + written, fallbackLength - written);
+                    if (n <= 0)
+                        break;
+                    written += n;
+                }
+                cerr << "Watchdog: turn overran; sent fallback" << endl;
+            }
+        }
+    }
+
+public:
+    Watchdog() : worker(&Watchdog::run, this) { }
+
+    ~Watchdog() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    /** Starts the turn's clock. Call it straight after the turn's first input is read,
+     * since the referee's time limit runs from when it sent that input. */
+    void startTurn() {
+        turnStart = Clock::now();
+    }
+
+    /** Copies out's pending commands as this turn's fallback, to be sent ms after the
+     * turn started. Call it once the fallback is written, before anything expensive. */
+    void arm(const CommandWriter &out, double ms) {
+        {
+            lock_guard<mutex> guard(lock);
+            fallbackLength = min<int>(out.size(), sizeof(fallback));
+            memcpy(fallback, out.data(), fallbackLength);
+            deadline = turnStart + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms));
+            armed = true;
+            answered = false;
+        }
+        wake.notify_one();
+    }
+
+    /** Sends out's commands, unless the watchdog beat us to it this turn, in which case
+     * they're discarded. Returns true if out was the answer that got sent. */
+    bool finish(CommandWriter &out) {
+        bool late = answered.exchange(true);
+        {
+            lock_guard<mutex> guard(lock);
+            armed = false;
+        }
+        wake.notify_one();
+
+        if (late) {
+            out.clear();
+            return false;
+        }
+        out.flush();
+        return true;
+    }
+};
+
+/** Named-phase timing. Open a ProfileScope at the top of a phase and it accrues calls
+ * and wall time to that name until it goes out of scope; nested scopes nest. The active
+ * phase is also what allocation and hardware-counter instrumentation attribute to.
+ * Phase tables are fixed-size arrays, so profiling never allocates.
+ *
+ * Compile with -DPROFILE to turn it on; ALLOC_PROFILE and PERF_COUNTERS turn it on too,
+ * since they attribute to its phases. Without a switch, ProfileScope is empty and
+ * endTurn() returns false straight away, so submitted bots pay nothing for the scopes. */
+#if defined(ALLOC_PROFILE) || defined(PERF_COUNTERS)
+#define PROFILE
+#endif
+
+#ifdef PROFILE
+
+namespace Profiler {
+    const int MAX_PHASES = 32;
+
+    struct Phase {
+        const char* name = nullptr;
+        long calls = 0;
+        double totalMs = 0;
+    };
+
+    inline Phase phases[MAX_PHASES];
+    inline int phaseCount = 0;
+    inline int current = -1;    // Index of the innermost open phase, or -1 outside any
+
+    /** Returns the index for a phase name, registering it on first use. */
+    inline int phaseId(const char* name) {
+        for (int i = 0; i < phaseCount; ++i)
+            if (phases[i].name == name || strcmp(phases[i].name, name) == 0)
+                return i;
+        if (phaseCount == MAX_PHASES)
+            return MAX_PHASES - 1;    // Out of room; lump the rest into the last phase
+        phases[phaseCount].name = name;
+        return phaseCount++;
+    }
+
+    inline const char* nameOf(int phase) {
+        return (phase < 0) ? "(no phase)" : phases[phase].name;
+    }
+
+    // Hooks for the optional instrumentation (AllocProfile.cpp, PerfCounters.cpp), which
+    // installs itself at startup when its build switch is on.
+    inline void (*onEnter)(int phase) = nullptr;
+    inline void (*onExit)(int phase) = nullptr;
+    inline void (*onTurnEnd)() = nullptr;
+    inline void (*reporters[4])() = {};
+    inline int reporterCount = 0;
+
+    inline void report() {
+        cerr << "Phase timings:" << endl;
+        for (int i = 0; i < phaseCount; ++i)
+            cerr << "  " << setw(24) << left << phases[i].name << right
+                << setw(8) << phases[i].calls << " calls "
+                << fixed << setprecision(3) << setw(10) << phases[i].totalMs << " ms" << endl;
+    }
+
+    /** Call once per turn, after the turn's output. Once stdin has closed, prints every
+     * report and returns true; the bot should then exit. Checking waits for the next
+     * turn's input, which is harmless with this turn's output already sent. */
+    inline bool endTurn() {
+        if (onTurnEnd)
+            onTurnEnd();
+
+        if ((cin >> ws).peek() != EOF)
+            return false;
+
+        report();
+        for (int i = 0; i < reporterCount; ++i)
+            reporters[i]();
+        return true;
+    }
+}
+
+class ProfileScope {
+    using Clock = chrono::steady_clock;
+
+    int phase;
+    int parent;
+    Clock::time_point start;
+
+public:
+    ProfileScope(const char* name)
+    : phase(Profiler::phaseId(name)),
+        parent(Profiler::current),
+        start(Clock::now())
+    {
+        Profiler::current = phase;
+        if (Profiler::onEnter)
+            Profiler::onEnter(phase);
+    }
+
+    ~ProfileScope() {
+        if (Profiler::onExit)
+            Profiler::onExit(phase);
+
+        Profiler::Phase &p = Profiler::phases[phase];
+        p.calls += 1;
+        p.totalMs += chrono::duration<double, milli>(Clock::now() - start).count();
+        Profiler::current = parent;
+    }
+};
+
+#else
+
+namespace Profiler {
+    inline bool endTurn() { return false; }
+}
+
+class ProfileScope {
+public:
+    ProfileScope(const char*) { }
+};
+
+#endif
+
+/* Allocation profiling
+
+Compile with -DALLOC_PROFILE to replace the global operator new/delete with counting
+versions. Every allocation is charged to the active ProfileScope (paste Profiler.cpp
+above this) for the current turn, and turns are closed by Profiler::endTurn(). Once
+stdin has closed, the report names the turn with the most allocations, its peak live
+bytes, and the phases responsible. Without the switch, this compiles to nothing.
+
+*/
+
+#ifdef ALLOC_PROFILE
+
+namespace AllocProfile {
+    struct Counts {
+        long allocs = 0;
+        long bytes = 0;
+    };
+
+    struct Turn {
+        int number = 0;
+        Counts total;
+        long peakLive = 0;
+        Counts byPhase[Profiler::MAX_PHASES + 1];   // [0] is outside any phase
+    };
+
+    inline Turn now;
+    inline Turn worst;
+    inline long live = 0;
+
+    inline void record(size_t bytes) {
+        now.total.allocs += 1;
+        now.total.bytes += bytes;
+        live += bytes;
+        now.peakLive = max(now.peakLive, live);
+
+        Counts &phase = now.byPhase[Profiler::current + 1];
+        phase.allocs += 1;
+        phase.bytes += bytes;
+    }
+
+    inline void report() {
+        cerr << "Worst turn for allocations: turn " << worst.number << ", "
+            << worst.total.allocs << " allocs, " << worst.total.bytes << " bytes, "
+            << worst.peakLive << " peak live bytes" << endl;
+
+        // Phases from most allocations to least; a selection sort over a handful is fine
+        bool shown[Profiler::MAX_PHASES + 1] = {};
+        for (int rank = 0; rank <= Profiler::MAX_PHASES; ++rank) {
+            int top = -1;
+            for (int i = 0; i <= Profiler::MAX_PHASES; ++i)
+                if (!shown[i] && worst.byPhase[i].allocs > 0
+                        && (top < 0 || worst.byPhase[i].allocs > worst.byPhase[top].allocs))
+                    top = i;
+            if (top < 0)
+                break;
+
+            shown[top] = true;
+            cerr << "  " << Profiler::nameOf(top - 1) << ": "
+                << worst.byPhase[top].allocs << " allocs, "
+                << worst.byPhase[top].bytes << " bytes" << endl;
+        }
+    }
+
+    inline void closeTurn() {
+        if (now.total.allocs > worst.total.allocs)
+            worst = now;
+
+        int number = now.number;
+        now = Turn();
+        now.number = number + 1;
+        now.peakLive = live;
+    }
+
+    inline bool installed = [] {
+        Profiler::onTurnEnd = closeTurn;
+        Profiler::reporters[Profiler::reporterCount++] = report;
+        return true;
+    }();
+}
+
+// Each block carries its size in a header, so delete can keep the live count right.
+// Kept out of line; inlined into containers, GCC mistakes the header offset for a bug.
+const size_t ALLOC_HEADER = alignof(max_align_t);
+
+__attribute__((noinline)) void* operator new(size_t bytes) {
+    void* block = malloc(bytes + ALLOC_HEADER);
+    if (!block)
+        throw bad_alloc();
+    *static_cast<size_t*>(block) = bytes;
+    AllocProfile::record(bytes);
+    return static_cast<char*>(block) + ALLOC_HEADER;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (!p)
+        return;
+    void* block = static_cast<char*>(p) - ALLOC_HEADER;
+    AllocProfile::live -= *static_cast<size_t*>(block);
+    free(block);
+}
+
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+#endif
+
+/** A vector with fixed, inline capacity: the elements live inside the object itself, so
+ * a StaticVector on the stack never touches the heap. Supports the subset of std::vector
+ * the bots use, including back_inserter and the <algorithm> iterator functions.
+ * Growing past N throws length_error rather than reallocating. */
+template <class T, int N>
+class StaticVector {
+    alignas(T) unsigned char storage[N * sizeof(T)];
+    int count = 0;
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using size_type = int;
+
+    StaticVector() { }
+
+    StaticVector(initializer_list<T> items) {
+        for (auto &item : items)
+            push_back(item);
+    }
+
+    template <class Iter>
+    StaticVector(Iter first, Iter last) {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    StaticVector(const StaticVector &other) {
+        for (auto &item : other)
+            push_back(item);
+    }
+
+    StaticVector& operator=(const StaticVector &other) {
+        if (this != &other) {
+            clear();
+            for (auto &item : other)
+                push_back(item);
+        }
+        return *this;
+    }
+
+    ~StaticVector() {
+        clear();
+    }
+
+    T* data() { return reinterpret_cast<T*>(storage); }
+    const T* data() const { return reinterpret_cast<const T*>(storage); }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + count; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + count; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    static constexpr int capacity() { return N; }
+
+    T& operator[](int i) { return data()[i]; }
+    const T& operator[](int i) const { return data()[i]; }
+
+    T& at(int i) {
+        if (i < 0 || i >= count)
+            throw out_of_range("StaticVector index out of range.");
+        return data()[i];
+    }
+
+    T& front() { return data()[0]; }
+    T& back() { return data()[count - 1]; }
+    const T& front() const { return data()[0]; }
+    const T& back() const { return data()[count - 1]; }
+
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == N)
+            throw length_error("StaticVector is at capacity.");
+        T* item = new (data() + count) T(forward<Args>(args)...);
+        ++count;
+        return *item;
+    }
+
+    void push_back(const T &item) { emplace_back(item); }
+    void push_back(T &&item) { emplace_back(move(item)); }
+
+    void pop_back() {
+        data()[--count].~T();
+    }
+
+    void clear() {
+        while (count > 0)
+            pop_back();
+    }
+
+    void resize(int n) {
+        while (count > n)
+            pop_back();
+        while (count < n)
+            emplace_back();
+    }
+
+    template <class Iter>
+    void assign(Iter first, Iter last) {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    /** Removes the element at pos by shifting the rest down; returns the following position. */
+    iterator erase(iterator pos) {
+        for (iterator it = pos; it + 1 != end(); ++it)
+            *it = move(*(it + 1));
+        pop_back();
+        return pos;
+    }
+
+    iterator erase(iterator first, iterator last) {
+        iterator out = first;
+        for (iterator it = last; it != end(); ++it, ++out)
+            *out = move(*it);
+        while (end() != out)
+            pop_back();
+        return first;
+    }
+};
+
+/** A bump allocator for per-turn scratch memory. One block is reserved up front;
+ * allocate() hands out aligned pieces of it by advancing an offset, and reset() at the
+ * end of the turn frees everything at once. Nothing is ever freed individually.
+ * Running out of the block throws bad_alloc, so size it for the worst turn. */
+class Arena {
+    unique_ptr<unsigned char[]> block;
+    size_t capacity;
+    size_t offset = 0;
+    size_t peak = 0;
+
+public:
+    Arena(size_t bytes) : block(new unsigned char[bytes]), capacity(bytes) { }
+
+    void* allocate(size_t bytes, size_t alignment = alignof(max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+        size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+
+        if (start + bytes > capacity)
+            throw bad_alloc();
+
+        offset = start + bytes;
+        peak = max(peak, offset);
+        return block.get() + start;
+    }
+
+    /** Frees everything allocated since construction or the last reset. */
+    void reset() { offset = 0; }
+
+    size_t used() const { return offset; }
+    size_t highWater() const { return peak; }
+};
+
+/** An STL allocator drawing from an Arena, so standard containers can live in turn
+ * scratch memory: vector<int, ArenaAllocator<int>> v(ArenaAllocator<int>(arena)).
+ * deallocate() is a no-op; memory comes back when the arena is reset, so containers
+ * using it must not outlive the turn. */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    Arena* arena;
+
+    ArenaAllocator(Arena &arena) : arena(&arena) { }
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) { }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) { }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+};
+
 struct Entity {
     int id;
     Point location;
@@ -79,10 +713,14 @@ struct Entity {
     int targetId;
     double priorityScore;
     bool abandoned = false;
+    bool alive = true;      // Only cleared by Simulation; the game never reports the dead.
 };
 
-vector<Entity> readSurvivors(int count) {
-    vector<Entity> list;
+using EntityList = StaticVector<Entity, MAX_ENTITIES>;
+
+EntityList readSurvivors(int count) {
+    ProfileScope scope("readSurvivors");
+    EntityList list;
     for (int i = 0; i < count; ++i) {
         Entity survivor;
         cin >> survivor.id
@@ -94,8 +732,9 @@ vector<Entity> readSurvivors(int count) {
     return list;
 }
 
-vector<Entity> readZombies(int count) {
-    vector<Entity> list;
+EntityList readZombies(int count) {
+    ProfileScope scope("readZombies");
+    EntityList list;
     for (int i = 0; i < count; ++i) {
         Entity zombie;
         cin >> zombie.id
@@ -107,23 +746,706 @@ vector<Entity> readZombies(int count) {
     return list;
 }
 
+/** Returns where something at `from` ends up after moving toward `to` by at most `speed`. */
+Point stepToward(const Point& from, const Point& to, int speed) {
+    double dist = from.distanceTo(to);
+    if (dist <= speed)
+        return to;
+    double ratio = speed / dist;
+    return Point(from.x + int((to.x - from.x) * ratio), from.y + int((to.y - from.y) * ratio));
+}
+
+/** An in-place turn simulator following the game's update order: zombies step toward
+ * their nearest human (Ash included), Ash steps toward his target, Ash shoots every
+ * zombie in range, then zombies eat whoever they're standing on.
+ *
+ * apply() mutates the state and returns a small Undo record; handing records back to
+ * undo() in reverse order restores the state exactly. Prior positions and deaths are
+ * journaled on stacks the simulation owns, so a depth-first search allocates nothing
+ * once the journals have grown to its depth. Dead entities stay in their vectors with
+ * alive == false, which keeps indices stable. Zombie .target fields are not maintained. */
+class Simulation {
+public:
+    struct Undo {
+        Point ash;
+        int score;
+        int movedSize;
+        int killedSize;
+        int eatenSize;
+    };
+
+    Point ash;
+    EntityList survivors;
+    EntityList zombies;
+    int survivorsAlive;
+    int zombiesAlive;
+    int score = 0;
+
+    Simulation(const Entity& ash, const EntityList& survivors, const EntityList& zombies)
+    : ash(ash.location),
+      survivors(survivors),
+      zombies(zombies),
+      survivorsAlive(survivors.size()),
+      zombiesAlive(zombies.size())
+    { }
+
+    bool over() const {
+        return survivorsAlive == 0 || zombiesAlive == 0;
+    }
+
+    Undo apply(const Point& ashTarget) {
+        Undo record {ash, score, int(movedJournal.size()), int(killedJournal.size()), int(eatenJournal.size())};
+
+        // Zombies move
+        for (int i = 0; i < zombies.size(); ++i) {
+            Entity& zombie = zombies[i];
+            if (!zombie.alive)
+                continue;
+
+            Point target = ash;
+            double closest = zombie.location.distanceTo(ash);
+            for (auto& survivor : survivors) {
+                if (!survivor.alive)
+                    continue;
+                double dist = zombie.location.distanceTo(survivor.location);
+                if (dist < closest) {
+                    closest = dist;
+                    target = survivor.location;
+                }
+            }
+
+            movedJournal.push_back({i, zombie.location});
+            zombie.location = stepToward(zombie.location, target, ZOMBIE_SPEED);
+        }
+
+        // Ash moves, then shoots
+        ash = stepToward(ash, ashTarget, ASH_SPEED);
+
+        int killPoints = 10 * survivorsAlive * survivorsAlive;
+        int fibA = 1, fibB = 1;     // Combo multiplier: 1, 2, 3, 5, 8...
+        for (int i = 0; i < zombies.size(); ++i) {
+            Entity& zombie = zombies[i];
+            if (!zombie.alive || zombie.location.distanceTo(ash) > SHOOT_DISTANCE)
+                continue;
+
+            zombie.alive = false;
+            --zombiesAlive;
+            killedJournal.push_back(i);
+
+            score += killPoints * fibB;
+            int fibNext = fibA + fibB;
+            fibA = fibB;
+            fibB = fibNext;
+        }
+
+        // Zombies eat
+        for (int i = 0; i < survivors.size(); ++i) {
+            Entity& survivor = survivors[i];
+            if (!survivor.alive)
+                continue;
+
+            bool eaten = any_of(zombies.begin(), zombies.end(), [&survivor](const Entity& zombie) {
+                return zombie.alive
+                    && zombie.location.x == survivor.location.x
+                    && zombie.location.y == survivor.location.y; });
+            if (!eaten)
+                continue;
+
+            survivor.alive = false;
+            --survivorsAlive;
+            eatenJournal.push_back(i);
+        }
+
+        if (survivorsAlive == 0)
+            score = 0;
+
+        return record;
+    }
+
+    void undo(const Undo& record) {
+        while (int(eatenJournal.size()) > record.eatenSize) {
+            survivors[eatenJournal.back()].alive = true;
+            ++survivorsAlive;
+            eatenJournal.pop_back();
+        }
+        while (int(killedJournal.size()) > record.killedSize) {
+            zombies[killedJournal.back()].alive = true;
+            ++zombiesAlive;
+            killedJournal.pop_back();
+        }
+        while (int(movedJournal.size()) > record.movedSize) {
+            zombies[movedJournal.back().index].location = movedJournal.back().location;
+            movedJournal.pop_back();
+        }
+        ash = record.ash;
+        score = record.score;
+    }
+
+private:
+    struct Moved {
+        int index;
+        Point location;
+    };
+
+    vector<Moved> movedJournal;
+    vector<int> killedJournal;
+    vector<int> eatenJournal;
+};
+
+/** A rollout model that jumps straight from one event to the next instead of stepping
+ * every turn. Between events everything moves in straight lines, so the turn a zombie
+ * reaches its human, the turn it comes into Ash's range and the turn Ash arrives can
+ * each be solved for in closed form; advance() skips to the earliest of them, resolves
+ * it, and re-aims only the zombies whose human just died or who are chasing a moving
+ * Ash. A rollout costs per event rather than per turn.
+ *
+ * This trades exactness for speed: positions are not truncated to integers, and a
+ * zombie that prefers Ash to every human heads for where Ash is going rather than
+ * turning after him each turn. Use Simulation where the exact game state matters. */
+class EventSimulation {
+public:
+    int turn = 0;
+    int score = 0;
+    int survivorsAlive;
+    int zombiesAlive;
+
+    EventSimulation(const Entity& ash, const EntityList& survivors, const EntityList& zombies)
+    : survivorsAlive(survivors.size()),
+      zombiesAlive(zombies.size())
+    {
+        this->ash = {{double(ash.location.x), double(ash.location.y)}, {0, 0}, 0, 0, ASH_SPEED};
+        for (auto& survivor : survivors)
+            humans.push_back({double(survivor.location.x), double(survivor.location.y), true});
+        for (auto& zombie : zombies) {
+            Walker walker {{double(zombie.location.x), double(zombie.location.y)}, {0, 0}, 0, 0, ZOMBIE_SPEED};
+            walkers.push_back({walker, -1, true, NEVER, NEVER});
+        }
+        for (auto& zombie : walkers)
+            aim(zombie);
+    }
+
+    bool over() const {
+        return survivorsAlive == 0 || zombiesAlive == 0;
+    }
+
+    /** Moves time forward to the next turn on which anything dies or Ash arrives, with
+     * Ash walking toward ashTarget meanwhile. Returns false, leaving the state alone,
+     * if the game is over or nothing would happen on or before lastTurn. */
+    bool advance(const Point& ashTarget, int lastTurn) {
+        if (over())
+            return false;
+
+        // A new heading for Ash moves every zombie's shot turn, and the chasers' courses
+        if (!ashHeading || ashTarget.x != ashGoal.x || ashTarget.y != ashGoal.y) {
+            ashHeading = true;
+            ashGoal = ashTarget;
+            ash.start = ash.at(turn);
+            setCourse(ash, {double(ashTarget.x), double(ashTarget.y)});
+            for (auto& zombie : walkers) {
+                if (!zombie.alive)
+                    continue;
+                if (zombie.human < 0)
+                    aim(zombie);
+                else
+                    zombie.shotTurn = shotTurn(zombie.walker);
+            }
+        }
+
+        int next = (ash.arrival() > turn) ? ash.arrival() : NEVER;
+        for (auto& zombie : walkers)
+            if (zombie.alive)
+                next = min(next, min(zombie.shotTurn, zombie.eatTurn));
+        if (next > lastTurn)
+            return false;
+
+        bool ashWalked = ash.arrival() > turn;
+        turn = next;
+        resolve(ashWalked);
+        return true;
+    }
+
+    /** Plays on until the game ends or lastTurn, with Ash heading for one spot throughout. */
+    int run(const Point& ashTarget, int lastTurn) {
+        while (advance(ashTarget, lastTurn))
+            ;
+        return score;
+    }
+
+private:
+    static const int NEVER = MAX_INT;
+
+    struct Vec {
+        double x, y;
+    };
+
+    /** Something moving from `start` along unit vector `dir` for `length` units at
+     * `speed` per turn, having set off at the end of turn `since`. */
+    struct Walker {
+        Vec start;
+        Vec dir;
+        double length;
+        int since;
+        int speed;
+
+        Vec at(double t) const {
+            double travelled = min(speed * max(0.0, t - since), length);
+            return {start.x + dir.x * travelled, start.y + dir.y * travelled};
+        }
+
+        /** The first turn on which the walker stands at its destination. */
+        int arrival() const {
+            return since + int(ceil(length / speed));
+        }
+    };
+
+    struct Human {
+        double x, y;
+        bool alive;
+    };
+
+    struct Zombie {
+        Walker walker;
+        int human;          // Index into humans, or -1 for Ash
+        bool alive;
+        int shotTurn;
+        int eatTurn;
+    };
+
+    Walker ash;
+    Point ashGoal;
+    bool ashHeading = false;
+    StaticVector<Human, MAX_ENTITIES> humans;
+    StaticVector<Zombie, MAX_ENTITIES> walkers;
+
+    void setCourse(Walker& walker, Vec to) {
+        double dx = to.x - walker.start.x, dy = to.y - walker.start.y;
+        walker.length = sqrt(dx*dx + dy*dy);
+        walker.dir = (walker.length > 0) ? Vec {dx / walker.length, dy / walker.length} : Vec {0, 0};
+        walker.since = turn;
+    }
+
+    /** Points a zombie at its nearest living human, or at Ash's destination if Ash is
+     * nearer. A zombie walking straight at a human stays nearest to that human, so this
+     * only needs redoing when the human dies. */
+    void aim(Zombie& zombie) {
+        Vec from = zombie.walker.start = zombie.walker.at(turn);
+        Vec ashNow = ash.at(turn);
+        double closest = (ashNow.x - from.x) * (ashNow.x - from.x) + (ashNow.y - from.y) * (ashNow.y - from.y);
+        zombie.human = -1;
+        for (int h = 0; h < int(humans.size()); ++h) {
+            if (!humans[h].alive)
+                continue;
+            double dist = (humans[h].x - from.x) * (humans[h].x - from.x) + (humans[h].y - from.y) * (humans[h].y - from.y);
+            if (dist < closest) {
+                closest = dist;
+                zombie.human = h;
+            }
+        }
+
+        if (zombie.human < 0) {
+            setCourse(zombie.walker, ash.at(ash.arrival()));
+            zombie.eatTurn = NEVER;
+        }
+        else {
+            setCourse(zombie.walker, {humans[zombie.human].x, humans[zombie.human].y});
+            zombie.eatTurn = max(turn + 1, zombie.walker.arrival());
+        }
+        zombie.shotTurn = shotTurn(zombie.walker);
+    }
+
+    /** The first turn after this one on which the zombie ends within Ash's range. Each
+     * stretch between arrivals is linear in t, so the in-range window on it is the span
+     * between the roots of |relative position|^2 = SHOOT_DISTANCE^2. */
+    int shotTurn(const Walker& zombie) const {
+        double zombieStops = zombie.since + zombie.length / zombie.speed;
+        double ashStops = ash.since + ash.length / ash.speed;
+        double breaks[] = {double(turn), min(zombieStops, ashStops), max(zombieStops, ashStops), double(NEVER)};
+
+        for (int piece = 0; piece < 3; ++piece) {
+            double a = max(breaks[piece], double(turn)), b = breaks[piece + 1];
+            if (b < turn + 1 || b <= a)
+                continue;
+
+            // Relative position p + v*(t - a) over the piece
+            Vec z = zombie.at(a), s = ash.at(a);
+            double zombieSpeed = (a < zombieStops) ? zombie.speed : 0;
+            double ashSpeed = (a < ashStops) ? ash.speed : 0;
+            Vec p {z.x - s.x, z.y - s.y};
+            Vec v {zombie.dir.x * zombieSpeed - ash.dir.x * ashSpeed, zombie.dir.y * zombieSpeed - ash.dir.y * ashSpeed};
+
+            double qa = v.x*v.x + v.y*v.y;
+            double qb = 2 * (p.x*v.x + p.y*v.y);
+            double qc = p.x*p.x + p.y*p.y - double(SHOOT_DISTANCE) * SHOOT_DISTANCE;
+
+            double enter, leave;
+            if (qa < 1e-12) {
+                if (qc > 0)
+                    continue;
+                enter = a;
+                leave = b;
+            }
+            else {
+                double disc = qb*qb - 4*qa*qc;
+                if (disc < 0)
+                    continue;
+                enter = a + (-qb - sqrt(disc)) / (2*qa);
+                leave = a + (-qb + sqrt(disc)) / (2*qa);
+            }
+
+            double first = max({enter, a, double(turn + 1)});
+            double candidate = ceil(first - 1e-9);
+            if (candidate <= min(leave, b) + 1e-9)
+                return int(candidate);
+        }
+        return NEVER;
+    }
+
+    void resolve(bool ashWalked) {
+        // Ash shoots before zombies eat
+        int killPoints = 10 * survivorsAlive * survivorsAlive;
+        int fibA = 1, fibB = 1;
+        for (auto& zombie : walkers) {
+            if (!zombie.alive || zombie.shotTurn != turn)
+                continue;
+
+            zombie.alive = false;
+            --zombiesAlive;
+            score += killPoints * fibB;
+            int fibNext = fibA + fibB;
+            fibA = fibB;
+            fibB = fibNext;
+        }
+
+        for (auto& zombie : walkers)
+            if (zombie.alive && zombie.eatTurn == turn && humans[zombie.human].alive) {
+                humans[zombie.human].alive = false;
+                --survivorsAlive;
+            }
+
+        if (survivorsAlive == 0) {
+            score = 0;
+            return;
+        }
+
+        // Those after Ash look again if he has been walking, since he may have left them
+        // nearer a human; anyone after a living human carries on as they were.
+        for (auto& zombie : walkers)
+            if (zombie.alive && (zombie.human < 0 ? ashWalked : !humans[zombie.human].alive))
+                aim(zombie);
+    }
+};
+
+/** Remembers each zombie's nearest human from one turn to the next, so most turns cost
+ * one distance per zombie instead of one per zombie-human pair. Humans never move, and
+ * a zombie walking straight at its nearest human stays nearest to it; any other step
+ * of length d can close the gap to the runner-up by at most 2d. Each zombie keeps that
+ * gap as a margin, and only rescans every human when its own human has died or the
+ * margin runs out. Ids index the tables directly; the game numbers both kinds from 0. */
+class NearestHumans {
+    struct Track {
+        bool known = false;
+        Point location;
+        int human;          // Id of the nearest human
+        double distance;
+        double margin;      // Lower bound on how much nearer this human is than any other
+    };
+
+    Track tracks[MAX_ENTITIES];
+    int indexOf[MAX_ENTITIES];
+    const EntityList* survivors = nullptr;
+
+    int rescan(Track& track, const Entity& zombie) {
+        int best = -1;
+        double closest = MAX_INT, runnerUp = MAX_INT;
+        for (int i = 0; i < survivors->size(); ++i) {
+            double dist = zombie.location.distanceTo((*survivors)[i].location);
+            if (dist < closest) {
+                runnerUp = closest;
+                closest = dist;
+                best = i;
+            }
+            else if (dist < runnerUp)
+                runnerUp = dist;
+        }
+
+        ++rescans;
+        track.known = best >= 0;
+        if (track.known) {
+            track.location = zombie.location;
+            track.human = (*survivors)[best].id;
+            track.distance = closest;
+            track.margin = runnerUp - closest;
+        }
+        return best;
+    }
+
+public:
+    int rescans = 0;        // Full scans so far; bench/nearest.cpp checks that they stay rare
+
+    /** Call once a turn, before nearest(), with the turn's survivors. */
+    void update(const EntityList& survivors) {
+        this->survivors = &survivors;
+        fill(indexOf, indexOf + MAX_ENTITIES, -1);
+        for (int i = 0; i < survivors.size(); ++i)
+            indexOf[survivors[i].id] = i;
+    }
+
+    /** Returns the index into this turn's survivors of the zombie's nearest one, or -1 if
+     * there are none. Ties go to the earlier survivor, as a linear scan would have it. */
+    int nearest(const Entity& zombie) {
+        Track& track = tracks[zombie.id];
+        if (!track.known || indexOf[track.human] < 0)
+            return rescan(track, zombie);
+
+        int index = indexOf[track.human];
+        double moved = track.location.distanceTo(zombie.location);
+        double dist = zombie.location.distanceTo((*survivors)[index].location);
+
+        // Positions are truncated each turn, so allow a unit or two of slack
+        bool straightAtIt = dist <= track.distance - moved + 2;
+        track.margin -= straightAtIt ? 4 : 2 * moved;
+        if (track.margin <= 0)
+            return rescan(track, zombie);
+
+        track.location = zombie.location;
+        track.distance = dist;
+        return index;
+    }
+};
+
+/** A coarse map of how good it would be for Ash to go and stand in each part of the
+ * board over the next few turns: how many humans would still be alive, and roughly what
+ * the kills along the way would score, combos included. Candidate moves can then be
+ * scored by lookup rather than by simulating each one.
+ *
+ * Each zombie is assumed to keep walking at its nearest human (or at Ash, if he is
+ * nearer). For every zombie, the grid keeps the window of turns during which it is in
+ * shooting range of each cell centre; that depends only on the zombie's path, so a row
+ * is reused for up to REUSE turns while the zombie is where its path said it would be.
+ * Rows cover PATH_TURNS rather than HORIZON, so a reused row still reaches the full
+ * horizon. Only the final pass, which brings in Ash's travel time to each cell, is
+ * redone every turn.
+ * All per-cell loops run over flat arrays so they vectorise. */
+class AshValueGrid {
+public:
+    static const int CELL_SIZE = 500;
+    static const int HORIZON = 10;      // Turns looked ahead
+    static const int REUSE = HORIZON / 2;           // Turns a zombie's row can be kept
+    static const int PATH_TURNS = HORIZON + REUSE;  // Turns each row covers
+    static const int COLUMNS = (BOARD_WIDTH + CELL_SIZE - 1) / CELL_SIZE;
+    static const int ROWS = (BOARD_HEIGHT + CELL_SIZE - 1) / CELL_SIZE;
+    static const int CELLS = COLUMNS * ROWS;
+
+    AshValueGrid() {
+        for (int c = 0; c < CELLS; ++c) {
+            centerX[c] = (c % COLUMNS + 0.5f) * CELL_SIZE;
+            centerY[c] = (c / COLUMNS + 0.5f) * CELL_SIZE;
+        }
+
+        // Combo multipliers run 1, 2, 3, 5, 8...
+        double a = 1, b = 1;
+        comboSum[0] = 0;
+        for (int n = 1; n <= MAX_ENTITIES; ++n) {
+            comboSum[n] = comboSum[n - 1] + b;
+            double next = a + b;
+            a = b;
+            b = next;
+        }
+    }
+
+    /** Call once a turn with the turn's input. */
+    void update(const Entity& ash, const EntityList& survivors, const EntityList& zombies) {
+        ProfileScope scope("AshValueGrid::update");
+        ++turn;
+        for (auto& zombie : zombies)
+            refreshPath(zombie, ash, survivors);
+        score(ash, survivors, zombies);
+    }
+
+    Point centerOf(int cell) const {
+        return Point(centerX[cell], centerY[cell]);
+    }
+
+    int cellOf(const Point& p) const {
+        int column = max(0, min(COLUMNS - 1, p.x / CELL_SIZE));
+        int row = max(0, min(ROWS - 1, p.y / CELL_SIZE));
+        return row * COLUMNS + column;
+    }
+
+    /** Humans expected to be alive at the horizon if Ash heads for p. */
+    int saved(const Point& p) const { return savedAt[cellOf(p)]; }
+
+    /** Rough points from the kills Ash would make before the horizon by heading for p. */
+    float points(const Point& p) const { return pointsAt[cellOf(p)]; }
+
+private:
+    static const int NEVER = 1 << 30;
+
+    /** A zombie's predicted path, and the turns it spends in range of each cell. */
+    struct Path {
+        int since = -1;         // Turn the path was worked out; -1 if never
+        int human;              // Id of the human it walks at, or -1 for Ash
+        float fromX, fromY;
+        float dirX, dirY;
+        float length;
+        int eatTurn;
+        int enter[CELLS];
+        int leave[CELLS];
+    };
+
+    int turn = 0;
+    float centerX[CELLS], centerY[CELLS];
+    vector<Path> paths = vector<Path>(MAX_ENTITIES);
+
+    int savedAt[CELLS];
+    float pointsAt[CELLS];
+
+    unsigned char kills[HORIZON][CELLS];            // Zombies shot on turn + 1 + t from cell c
+    unsigned char doomed[MAX_ENTITIES][CELLS];      // Whether the h'th survivor is eaten anyway
+    float comboSum[MAX_ENTITIES + 1];               // What n kills in one turn are worth, over 10h^2
+
+    bool onCourse(const Path& path, const Entity& zombie, const EntityList& survivors) const {
+        if (path.since < 0 || path.human < 0 || turn - path.since > REUSE)
+            return false;
+        bool humanAlive = any_of(survivors.begin(), survivors.end(),
+            [&path](const Entity& survivor) { return survivor.id == path.human; });
+        float travelled = min(float(ZOMBIE_SPEED) * (turn - path.since), path.length);
+        float dx = path.fromX + path.dirX * travelled - zombie.location.x;
+        float dy = path.fromY + path.dirY * travelled - zombie.location.y;
+        return humanAlive && dx*dx + dy*dy <= 9;
+    }
+
+    void refreshPath(const Entity& zombie, const Entity& ash, const EntityList& survivors) {
+        Path& path = paths[zombie.id];
+        if (onCourse(path, zombie, survivors))
+            return;
+
+        path.since = turn;
+        path.fromX = zombie.location.x;
+        path.fromY = zombie.location.y;
+
+        const Entity* target = nullptr;
+        double closest = zombie.location.distanceTo(ash.location);
+        for (auto& survivor : survivors) {
+            double dist = zombie.location.distanceTo(survivor.location);
+            if (dist < closest) {
+                closest = dist;
+                target = &survivor;
+            }
+        }
+
+        const float range2 = float(SHOOT_DISTANCE) * SHOOT_DISTANCE;
+
+        // A zombie after Ash follows him to whichever cell he picks
+        if (!target) {
+            path.human = -1;
+            path.eatTurn = NEVER;
+            for (int c = 0; c < CELLS; ++c) {
+                float dx = centerX[c] - path.fromX, dy = centerY[c] - path.fromY;
+                float gap = sqrt(dx*dx + dy*dy) - SHOOT_DISTANCE;
+                path.enter[c] = turn + max(1, int(ceil(gap / ZOMBIE_SPEED)));
+                path.leave[c] = NEVER;
+            }
+            return;
+        }
+
+        path.human = target->id;
+        float dx = target->location.x - path.fromX, dy = target->location.y - path.fromY;
+        path.length = sqrt(dx*dx + dy*dy);
+        path.dirX = (path.length > 0) ? dx / path.length : 0;
+        path.dirY = (path.length > 0) ? dy / path.length : 0;
+        path.eatTurn = turn + max(1, int(ceil(path.length / ZOMBIE_SPEED)));
+
+        fill(path.enter, path.enter + CELLS, NEVER);
+        fill(path.leave, path.leave + CELLS, -1);
+        for (int t = 1; t <= PATH_TURNS; ++t) {
+            float travelled = min(float(ZOMBIE_SPEED) * t, path.length);
+            float px = path.fromX + path.dirX * travelled;
+            float py = path.fromY + path.dirY * travelled;
+            int when = turn + t;
+            for (int c = 0; c < CELLS; ++c) {
+                float ex = centerX[c] - px, ey = centerY[c] - py;
+                bool inRange = ex*ex + ey*ey <= range2;
+                path.enter[c] = inRange ? min(path.enter[c], when) : path.enter[c];
+                path.leave[c] = inRange ? when : path.leave[c];
+            }
+        }
+    }
+
+    void score(const Entity& ash, const EntityList& survivors, const EntityList& zombies) {
+        int arrival[CELLS];
+        for (int c = 0; c < CELLS; ++c) {
+            float dx = centerX[c] - ash.location.x, dy = centerY[c] - ash.location.y;
+            arrival[c] = turn + max(1, int(ceil(sqrt(dx*dx + dy*dy) / ASH_SPEED)));
+        }
+
+        memset(kills, 0, sizeof(kills));
+        memset(doomed, 0, survivors.size() * sizeof(doomed[0]));
+
+        int horizonEnd = turn + HORIZON;
+        int killAt[CELLS];
+        for (auto& zombie : zombies) {
+            const Path& path = paths[zombie.id];
+            int deadline = min(path.eatTurn, horizonEnd);
+            for (int c = 0; c < CELLS; ++c) {
+                int kill = max(path.enter[c], arrival[c]);
+                killAt[c] = (kill <= path.leave[c] && kill <= deadline) ? kill : NEVER;
+            }
+
+            for (int t = 0; t < HORIZON; ++t)
+                for (int c = 0; c < CELLS; ++c)
+                    kills[t][c] += killAt[c] == turn + 1 + t;
+
+            // Not shot before it reaches its human, and that happens within the horizon
+            int victim = -1;
+            for (int h = 0; h < survivors.size(); ++h)
+                if (survivors[h].id == path.human)
+                    victim = h;
+            if (victim >= 0 && path.eatTurn <= horizonEnd)
+                for (int c = 0; c < CELLS; ++c)
+                    doomed[victim][c] |= killAt[c] == NEVER;
+        }
+
+        for (int c = 0; c < CELLS; ++c) {
+            int lost = 0;
+            for (int h = 0; h < survivors.size(); ++h)
+                lost += doomed[h][c];
+            savedAt[c] = survivors.size() - lost;
+
+            float combos = 0;
+            for (int t = 0; t < HORIZON; ++t)
+                combos += comboSum[kills[t][c]];
+            pointsAt[c] = 10.0f * savedAt[c] * savedAt[c] * combos;
+        }
+    }
+};
+
 struct GetTargetOptions {
     Entity& ash;
     int survivor_count;
-    vector<Entity>& survivors;
+    EntityList& survivors;
     int zombie_count;
-    vector<Entity>& zombies;
+    EntityList& zombies;
+    Arena& scratch;         // Per-turn memory; reset by main after each turn.
+    NearestHumans& nearest; // Kept by main across turns.
+    AshValueGrid& grid;     // Updated by main each turn.
 };
 
 namespace GetTarget {
     Entity survivorByIndex(const GetTargetOptions& args);
     Entity zombieByIndex(const GetTargetOptions& args);
     Entity triageByTime(const GetTargetOptions& args);
+    Entity checkByRollout(const GetTargetOptions& args, const Entity& choice);
 }
 
 int main()
 {
     int prioritizedId = -1;
+    Arena scratch(1 << 16);
+    NearestHumans nearest;
+    AshValueGrid grid;
+    CommandWriter out;
+    Watchdog watchdog;
 
     // game loop
     while (1) {
@@ -131,41 +1453,59 @@ int main()
         Entity ash;
         ash.id = -1;
         cin >> ash.location.x >> ash.location.y; cin.ignore();
+        watchdog.startTurn();
         ash.target = Point(ash.location);
 
         int survivor_count;
         cin >> survivor_count; cin.ignore();
-        vector<Entity> survivors = readSurvivors(survivor_count);
+        EntityList survivors = readSurvivors(survivor_count);
+        nearest.update(survivors);
 
         int zombie_count;
         cin >> zombie_count; cin.ignore();
-        vector<Entity> zombies = readZombies(zombie_count);
+        EntityList zombies = readZombies(zombie_count);
 
-        ////// Get target entity
+        ////// Fallback: last turn's zombie if it's still up, else this turn's triage
+        GetTargetOptions options {ash, survivor_count, survivors, zombie_count, zombies, scratch, nearest, grid};
         auto matchingId = [prioritizedId](Entity zombie) { return zombie.id == prioritizedId; };
-        Entity target = (any_of(zombies.begin(), zombies.end(), matchingId))
-            ? *find_if(zombies.begin(), zombies.end(), matchingId)
-            : GetTarget::triageByTime({ash, survivor_count, survivors, zombie_count, zombies});
+        Entity* prioritized = find_if(zombies.begin(), zombies.end(), matchingId);
+        Entity fallback = (prioritized != zombies.end()) ? *prioritized : GetTarget::triageByTime(options);
+        out << fallback.target.x << ' ' << fallback.target.y << '\n';
+        watchdog.arm(out, TURN_TIMEOUT_MS);
+        out.clear();
+
+        ////// Get target entity
+        grid.update(ash, survivors, zombies);
+        Entity target = (prioritized != zombies.end())
+            ? fallback
+            : GetTarget::checkByRollout(options, fallback);
 
         prioritizedId = target.id;
         
         // Final instruction yield
-        cout << string(target.target) << " target " << target.id << endl;
+        out << target.target.x << ' ' << target.target.y << " target " << target.id << '\n';
+        watchdog.finish(out);
+
+        scratch.reset();
+
+        if (Profiler::endTurn())
+            return 0;
     }
 }
 
 Entity GetTarget::survivorByIndex(const GetTargetOptions &args) {
-    auto [ash, survivor_count, survivors, zombie_count, zombies] = args;
+    auto [ash, survivor_count, survivors, zombie_count, zombies, scratch, nearest, grid] = args;
     return *survivors.begin();
 }
 
 Entity GetTarget::zombieByIndex(const GetTargetOptions &args) {
-    auto [ash, survivor_count, survivors, zombie_count, zombies] = args;
+    auto [ash, survivor_count, survivors, zombie_count, zombies, scratch, nearest, grid] = args;
     return *zombies.begin();
 }
 
 Entity GetTarget::triageByTime(const GetTargetOptions &args) {
-    auto [ash, survivor_count, survivors, zombie_count, zombies] = args;
+    ProfileScope scope("triageByTime");
+    auto [ash, survivor_count, survivors, zombie_count, zombies, scratch, nearest, grid] = args;
 
     // Calc zombie priority scores
     for (auto& zombie : zombies) {
@@ -174,12 +1514,10 @@ Entity GetTarget::triageByTime(const GetTargetOptions &args) {
         Entity closestTarget;
 
         // Get dist for closest target
-        for (auto& survivor : survivors) {
-            double distTosurvivor = zombie.location.distanceTo(survivor.location);
-            if (distTosurvivor < distClosestSurvivor) {
-                distClosestSurvivor = distTosurvivor;
-                closestTarget = survivor;
-            }
+        int closestIndex = nearest.nearest(zombie);
+        if (closestIndex >= 0) {
+            closestTarget = survivors[closestIndex];
+            distClosestSurvivor = zombie.location.distanceTo(closestTarget.location);
         }
 
         double distAshToZombie = zombie.location.distanceTo(ash.location);
@@ -219,14 +1557,15 @@ Entity GetTarget::triageByTime(const GetTargetOptions &args) {
         return survivor.abandoned;
     };
 
-    vector<Entity> availableTargets;
+    vector<Entity, ArenaAllocator<Entity>> availableTargets(scratch);
+    availableTargets.reserve(zombies.size());
     copy_if(zombies.begin(), zombies.end(), back_inserter(availableTargets),
         [&](const Entity& zombie) {
             return zombie.priorityScore > 0.0
                 && !idIsAbandoned(zombie.targetId); });
 
     if (availableTargets.size() == 0) {
-        availableTargets = zombies;
+        availableTargets.assign(zombies.begin(), zombies.end());
         for_each(availableTargets.begin(), availableTargets.end(),
             [ash](Entity& zombie){ zombie.priorityScore = zombie.location.distanceTo(ash.location); });
     }
@@ -237,3 +1576,52 @@ Entity GetTarget::triageByTime(const GetTargetOptions &args) {
     return prioritizedTarget;
 }
 
+/** Plays the game out with EventSimulation for ROLLOUT_TURNS with Ash heading for the
+ * chosen zombie, and again for each of the GRID_CANDIDATES cells the AshValueGrid rates
+ * best by lookup. Whichever leaves the most humans alive (then scores the most) is
+ * taken; a cell comes back as an Entity with id -1, so triage runs again next turn.
+ * If every human is lost all the same, each zombie gets a rollout of its own. Triage
+ * ranks zombies one at a time, so it can send Ash on a rescue that leaves everyone
+ * else to be eaten, and it never waits for a combo. */
+Entity GetTarget::checkByRollout(const GetTargetOptions &args, const Entity& choice) {
+    ProfileScope scope("checkByRollout");
+    auto [ash, survivor_count, survivors, zombie_count, zombies, scratch, nearest, grid] = args;
+
+    pair<int, int> best = {-1, 0};
+    Entity bestTarget = choice;
+    auto rollout = [&](const Entity& candidate) {
+        EventSimulation simulation(ash, survivors, zombies);
+        simulation.run(candidate.target, ROLLOUT_TURNS);
+        pair<int, int> outcome = {simulation.survivorsAlive, simulation.score};
+        if (outcome > best) {
+            best = outcome;
+            bestTarget = candidate;
+        }
+    };
+
+    rollout(choice);
+
+    auto value = [&grid](int cell) {
+        Point center = grid.centerOf(cell);
+        return make_pair(grid.saved(center), grid.points(center));
+    };
+    vector<int, ArenaAllocator<int>> cells(scratch);
+    cells.reserve(AshValueGrid::CELLS);
+    for (int c = 0; c < AshValueGrid::CELLS; ++c)
+        cells.push_back(c);
+    int candidates = min<int>(GRID_CANDIDATES, cells.size());
+    partial_sort(cells.begin(), cells.begin() + candidates, cells.end(),
+        [&value](int a, int b) { return value(a) > value(b); });
+
+    for (int i = 0; i < candidates; ++i) {
+        Entity spot;
+        spot.id = -1;
+        spot.location = spot.target = grid.centerOf(cells[i]);
+        rollout(spot);
+    }
+
+    if (best.first == 0)
+        for (auto& zombie : zombies)
+            rollout(zombie);
+    return bestTarget;
+}
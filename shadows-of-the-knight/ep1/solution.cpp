@@ -1,6 +1,10 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
 
 using namespace std;
 
@@ -37,6 +41,100 @@ public:
   }
 };
 
+/** Builds a turn's output in a buffer and hands it to the OS with one write() call; no
+ * iostreams, locales or per-line flushes. Integers are formatted two digits at a time
+ * from a lookup table. The buffer grows rather than flushing early, so nothing reaches
+ * stdout before flush(); the Watchdog relies on that to discard a late answer.
+ *
+ *   out << "MOVE " << x << ' ' << y << '\n';
+ *   out.flush();   // once, after the turn's last command
+ *
+ * Don't mix with cout in the same bot; the two buffers would interleave. */
+class CommandWriter {
+  vector<char> buffer = vector<char>(4096);
+  int length = 0;
+
+  void reserve(int n) {
+    if (length + n > int(buffer.size()))
+      buffer.resize(max<size_t>(buffer.size() * 2, length + n));
+  }
+
+public:
+
+  CommandWriter& operator<<(char c) {
+    reserve(1);
+    buffer[length++] = c;
+    return *this;
+  }
+
+  CommandWriter& operator<<(const char* s) {
+    int n = strlen(s);
+    reserve(n);
+    memcpy(buffer.data() + length, s, n);
+    length += n;
+    return *this;
+  }
+
+  CommandWriter& operator<<(const string &s) {
+    reserve(s.size());
+    memcpy(buffer.data() + length, s.data(), s.size());
+    length += s.size();
+    return *this;
+  }
+
+  CommandWriter& operator<<(int n) {
+    static const char digitPairs[] =
+      "00010203040506070809" "10111213141516171819" "20212223242526272829"
+      "30313233343536373839" "40414243444546474849" "50515253545556575859"
+      "60616263646566676869" "70717273747576777879" "80818283848586878889"
+      "90919293949596979899";
+
+    reserve(11);
+    unsigned int u = (n < 0) ? 0u - unsigned(n) : unsigned(n);
+    if (n < 0)
+      buffer[length++] = '-';
+
+    char digits[10];
+    int i = 10;
+    while (u >= 100) {
+      int pair = (u % 100) * 2;
+      u /= 100;
+      digits[--i] = digitPairs[pair + 1];
+      digits[--i] = digitPairs[pair];
+    }
+    if (u >= 10) {
+      digits[--i] = digitPairs[u * 2 + 1];
+      digits[--i] = digitPairs[u * 2];
+    }
+    else
+      digits[--i] = '0' + u;
+
+    memcpy(buffer.data() + length, digits + i, 10 - i);
+    length += 10 - i;
+    return *this;
+  }
+
+  const char* data() const { return buffer.data(); }
+  int size() const { return length; }
+
+  /** Discards everything buffered. */
+  void clear() {
+    length = 0;
+  }
+
+  /** Writes everything buffered to stdout. */
+  void flush() {
+    int written = 0;
+    while (written < length) {
+      int n = write(STDOUT_FILENO, buffer.data() + written, length - written);
+      if (n <= 0)
+        break;
+      written += n;
+    }
+    length = 0;
+  }
+};
+
 
 int main()
 {
@@ -52,6 +150,8 @@ int main()
   Point topleft(0,0);
   Point bottomright(width,height);
 
+  CommandWriter out;
+
   // game loop
   while (true) {
     string dir;
@@ -72,7 +172,8 @@ int main()
     // Get search center
     pos = (bottomright - topleft) / 2 + topleft;
 
-    cout << string(pos) << endl;
+    out << pos.x << ' ' << pos.y << '\n';
+    out.flush();
   }
 
 }
\ No newline at end of file
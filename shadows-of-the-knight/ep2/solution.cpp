@@ -5,7 +5,22 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <tuple>
 #include <cmath>
+#include <new>
+#include <utility>
+
+#include <cstring>
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
 
 using namespace std;
 
@@ -38,6 +53,9 @@ bool within(double n, double min, double max) {
     return (min <= n && n <= max);
 }
 
+const int TURN_TIMEOUT_MS = 140;   // Of the 150ms the referee allows
+const int PIVOT_STEPS = 32;        // Turns tried either side of the reflection when its cut misses
+
 double clamp(double n, double min, double max) {
     return ::max(min, ::min(max, n));
 }
@@ -111,15 +129,19 @@ public:
   }
 
   /** Yields a fast approximation of this Point's unit vector; returns a new Point.  
-   * The shape this creates is an octagon inscribed in the ideal circle.
+   * The shape this creates is an octagon inscribed in the ideal circle. The zero
+   * vector yields the zero vector. bench/geometry.cpp measures the error.
    * @author Nick Vogt */
   Point fastUnitVector() const {
+    if (x == 0 && y == 0)
+      return Point();
+
     // 0.29289 ~= 1 - 1/sqrt(2)
     // 1.29289 ~= 2 - 1/sqrt(2)
 
     double ax = x*(x >= 0) + -x*(x < 0);            // absolute coords
     double ay = y*(y >= 0) + -y*(y < 0);
-    double ratio = 1 / ( x*(x >= y) + y*(x < y));   // 1 / max(x, y)
+    double ratio = 1 / ( ax*(ax >= ay) + ay*(ax < ay));   // 1 / max(|x|, |y|)
     ratio = ratio * (1.29289 - (ax + ay) * ratio * 0.29289);
       // some trigonometry involving how diagonally-pointed the vector is
 
@@ -145,193 +167,730 @@ public:
 
 };
 
-class Line {
-public: 
-    const Point A;
-    const Point B;
-    const Point vec;
-    const double slope;
-    const double lift;
-
-    Line(const Point &A, const Point &B)
-    : A(A),
-      B(B),
-      vec(B-A),
-      slope(vec.slope()),
-      lift(-slope*A.x + A.y)
-    {
-        if (vec.manhattanMagnitude() == 0.0) {
-            stringstream s;
-            s << "The points given do not describe a valid line: A == B == " << string(A);
-            throw invalid_argument(s.str());
-        }
-    }
+/** Builds a turn's output in a buffer and hands it to the OS with one write() call; no
+ * iostreams, locales or per-line flushes. Integers are formatted two digits at a time
+ * from a lookup table. The buffer grows rather than flushing early, so nothing reaches
+ * stdout before flush(); the Watchdog relies on that to discard a late answer.
+ *
+ *   out << "MOVE " << x << ' ' << y << '\n';
+ *   out.flush();   // once, after the turn's last command
+ *
+ * Don't mix with cout in the same bot; the two buffers would interleave. */
+class CommandWriter {
+  vector<char> buffer = vector<char>(4096);
+  int length = 0;
+
+  void reserve(int n) {
+    if (length + n > int(buffer.size()))
+      buffer.resize(max<size_t>(buffer.size() * 2, length + n));
+  }
 
-    /** Returns a <bool,Point> pair, where the point describes where these two lines intersect.
-     * The bool component is true if these lines do intersect, and false if they do not. */
-    optional<Point> intersection(const Line &other) const {
-        // This method uses vector cross-products to determine a ratio for line A (this)
-        // by which its travel vector should be multiplied to arrive at the intersection
-        // point.
+public:
 
-        Point vecA = vec;
-        Point vecB = other.vec;
-        Point vecC = A - other.A;   // A vector from this to other's origin point.
+  CommandWriter& operator<<(char c) {
+    reserve(1);
+    buffer[length++] = c;
+    return *this;
+  }
 
-        double denom = vecA.crossZ(vecB);
+  CommandWriter& operator<<(const char* s) {
+    int n = strlen(s);
+    reserve(n);
+    memcpy(buffer.data() + length, s, n);
+    length += n;
+    return *this;
+  }
 
-        if (denom == 0.0)
-            return nullopt;
+  CommandWriter& operator<<(const string &s) {
+    reserve(s.size());
+    memcpy(buffer.data() + length, s.data(), s.size());
+    length += s.size();
+    return *this;
+  }
+
+  CommandWriter& operator<<(int n) {
+    static const char digitPairs[] =
+      "00010203040506070809" "10111213141516171819" "20212223242526272829"
+      "30313233343536373839" "40414243444546474849" "50515253545556575859"
+      "60616263646566676869" "70717273747576777879" "80818283848586878889"
+      "90919293949596979899";
+
+    reserve(11);
+    unsigned int u = (n < 0) ? 0u - unsigned(n) : unsigned(n);
+    if (n < 0)
+      buffer[length++] = '-';
+
+    char digits[10];
+    int i = 10;
+    while (u >= 100) {
+      int pair = (u % 100) * 2;
+      u /= 100;
+      digits[--i] = digitPairs[pair + 1];
+      digits[--i] = digitPairs[pair];
+    }
+    if (u >= 10) {
+      digits[--i] = digitPairs[u * 2 + 1];
+      digits[--i] = digitPairs[u * 2];
+    }
+    else
+      digits[--i] = '0' + u;
+
+    memcpy(buffer.data() + length, digits + i, 10 - i);
+    length += 10 - i;
+    return *this;
+  }
 
-        // double s = vecA.cross(vecC) / denom;
-        double t = vecB.crossZ(vecC) / denom;
+  const char* data() const { return buffer.data(); }
+  int size() const { return length; }
 
-        // The lines' travel vectors themselves intersect if s && t are each within the interval [0,1]
+  /** Discards everything buffered. */
+  void clear() {
+    length = 0;
+  }
 
-        return A + vec*t;
+  /** Writes everything buffered to stdout. */
+  void flush() {
+    int written = 0;
+    while (written < length) {
+      int n = write(STDOUT_FILENO, buffer.data() + written, length - written);
+      if (n <= 0)
+        break;
+      written += n;
     }
+    length = 0;
+  }
+};
 
-    bool pointInSegment(const Point &P) const {
-        bool isA = (A == P);    // TODO Within what precision?
-        bool isParallel = vec.crossZ(P - A) < 0.002;    // Quantized b/c floating points
-        bool inBounds = within(P.x, A.x, B.x) && within(P.y, A.y, B.y);
+/** Guarantees an answer every turn. The turn's clock starts when its first input is
+ * read. The bot then writes a cheap fallback command into its CommandWriter and arms
+ * the watchdog with it, before any expensive thinking. If finish() hasn't been called
+ * by the deadline, a background thread writes the fallback itself, and whatever the bot
+ * sends later that turn is discarded instead.
+ *
+ *   cin >> ...;                            // the turn's first read; blocks until it arrives
+ *   watchdog.startTurn();
+ *   // read the rest; out << fallback...;
+ *   watchdog.arm(out, TURN_TIMEOUT_MS);    // deadline is startTurn() + TURN_TIMEOUT_MS
+ *   // expensive search: out.clear() and write something better
+ *   watchdog.finish(out);
+ *
+ * Needs CommandWriter pasted above it. */
+class Watchdog {
+  using Clock = chrono::steady_clock;
+
+  mutex lock;
+  condition_variable wake;
+  char fallback[1024];
+  int fallbackLength = 0;
+  Clock::time_point turnStart = Clock::now();
+  Clock::time_point deadline;
+  bool armed = false;
+  bool stopping = false;
+  atomic<bool> answered {true};   // Whoever flips this first owns the turn's output
+  thread worker;                  // Last, so it starts after everything above is ready
+
+  void run() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+      if (!armed) {
+        wake.wait(guard);
+        continue;
+      }
+
+      if (wake.wait_until(guard, deadline) != cv_status::timeout || !armed)
+        continue;
+
+      armed = false;
+      if (!answered.exchange(true)) {
+        int written = 0;
+        while (written < fallbackLength) {
+          int n = write(STDOUT_FILENO, fallback + written, fallbackLength - written);
+          if (n <= 0)
+            break;
+          written += n;
+        }
+        cerr << "Watchdog: turn overran; sent fallback" << endl;
+      }
+    }
+  }
+
+public:
+  Watchdog() : worker(&Watchdog::run, this) { }
 
-        return (isA || isParallel) && inBounds;
+  ~Watchdog() {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
     }
+    wake.notify_one();
+    worker.join();
+  }
 
-    bool parallel(const Line &other) const {
-        return (vec.crossZ(other.vec) == 0.0);
+  /** Starts the turn's clock. Call it straight after the turn's first input is read,
+   * since the referee's time limit runs from when it sent that input. */
+  void startTurn() {
+    turnStart = Clock::now();
+  }
+
+  /** Copies out's pending commands as this turn's fallback, to be sent ms after the
+   * turn started. Call it once the fallback is written, before anything expensive. */
+  void arm(const CommandWriter &out, double ms) {
+    {
+      lock_guard<mutex> guard(lock);
+      fallbackLength = min<int>(out.size(), sizeof(fallback));
+      memcpy(fallback, out.data(), fallbackLength);
+      deadline = turnStart + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms));
+      armed = true;
+      answered = false;
     }
+    wake.notify_one();
+  }
 
-    bool operator==(const Line &other) const {
-        bool isParallel = parallel(other);
-        bool sharedCoordSpace = (lift == other.lift);   // TODO ..? Slope is implicit in isParallel, so...
-        return isParallel && sharedCoordSpace;
+  /** Sends out's commands, unless the watchdog beat us to it this turn, in which case
+   * they're discarded. Returns true if out was the answer that got sent. */
+  bool finish(CommandWriter &out) {
+    bool late = answered.exchange(true);
+    {
+      lock_guard<mutex> guard(lock);
+      armed = false;
     }
+    wake.notify_one();
 
-    operator string() const {
-        stringstream s;
-        s << fixed << setprecision(3)
-          << "[y = " << slope << "x + " << lift << "]";
-        return s.str();
+    if (late) {
+      out.clear();
+      return false;
     }
+    out.flush();
+    return true;
+  }
 };
 
-class Polygon {
-    vector<Point> vertices;
+/** Named-phase timing. Open a ProfileScope at the top of a phase and it accrues calls
+ * and wall time to that name until it goes out of scope; nested scopes nest. The active
+ * phase is also what allocation and hardware-counter instrumentation attribute to.
+ * Phase tables are fixed-size arrays, so profiling never allocates.
+ *
+ * Compile with -DPROFILE to turn it on; ALLOC_PROFILE and PERF_COUNTERS turn it on too,
+ * since they attribute to its phases. Without a switch, ProfileScope is empty and
+ * endTurn() returns false straight away, so submitted bots pay nothing for the scopes. */
+#if defined(ALLOC_PROFILE) || defined(PERF_COUNTERS)
+#define PROFILE
+#endif
+
+#ifdef PROFILE
+
+namespace Profiler {
+  const int MAX_PHASES = 32;
+
+  struct Phase {
+    const char* name = nullptr;
+    long calls = 0;
+    double totalMs = 0;
+  };
+
+  inline Phase phases[MAX_PHASES];
+  inline int phaseCount = 0;
+  inline int current = -1;    // Index of the innermost open phase, or -1 outside any
+
+  /** Returns the index for a phase name, registering it on first use. */
+  inline int phaseId(const char* name) {
+    for (int i = 0; i < phaseCount; ++i)
+      if (phases[i].name == name || strcmp(phases[i].name, name) == 0)
+        return i;
+    if (phaseCount == MAX_PHASES)
+      return MAX_PHASES - 1;    // Out of room; lump the rest into the last phase
+    phases[phaseCount].name = name;
+    return phaseCount++;
+  }
+
+  inline const char* nameOf(int phase) {
+    return (phase < 0) ? "(no phase)" : phases[phase].name;
+  }
+
+  // Hooks for the optional instrumentation (AllocProfile.cpp, PerfCounters.cpp), which
+  // installs itself at startup when its build switch is on.
+  inline void (*onEnter)(int phase) = nullptr;
+  inline void (*onExit)(int phase) = nullptr;
+  inline void (*onTurnEnd)() = nullptr;
+  inline void (*reporters[4])() = {};
+  inline int reporterCount = 0;
+
+  inline void report() {
+    cerr << "Phase timings:" << endl;
+    for (int i = 0; i < phaseCount; ++i)
+      cerr << "  " << setw(24) << left << phases[i].name << right
+        << setw(8) << phases[i].calls << " calls "
+        << fixed << setprecision(3) << setw(10) << phases[i].totalMs << " ms" << endl;
+  }
+
+  /** Call once per turn, after the turn's output. Once stdin has closed, prints every
+   * report and returns true; the bot should then exit. Checking waits for the next
+   * turn's input, which is harmless with this turn's output already sent. */
+  inline bool endTurn() {
+    if (onTurnEnd)
+      onTurnEnd();
+
+    if ((cin >> ws).peek() != EOF)
+      return false;
+
+    report();
+    for (int i = 0; i < reporterCount; ++i)
+      reporters[i]();
+    return true;
+  }
+}
+
+class ProfileScope {
+  using Clock = chrono::steady_clock;
+
+  int phase;
+  int parent;
+  Clock::time_point start;
 
 public:
+  ProfileScope(const char* name)
+  : phase(Profiler::phaseId(name)),
+    parent(Profiler::current),
+    start(Clock::now())
+  {
+    Profiler::current = phase;
+    if (Profiler::onEnter)
+      Profiler::onEnter(phase);
+  }
 
-    Polygon(const vector<Point> &points) : vertices(points) {
-        // Check that each point is unique?
+  ~ProfileScope() {
+    if (Profiler::onExit)
+      Profiler::onExit(phase);
+
+    Profiler::Phase &p = Profiler::phases[phase];
+    p.calls += 1;
+    p.totalMs += chrono::duration<double, milli>(Clock::now() - start).count();
+    Profiler::current = parent;
+  }
+};
+
+#else
+
+namespace Profiler {
+  inline bool endTurn() { return false; }
+}
+
+class ProfileScope {
+public:
+  ProfileScope(const char*) { }
+};
+
+#endif
+
+/* Allocation profiling
+
+Compile with -DALLOC_PROFILE to replace the global operator new/delete with counting
+versions. Every allocation is charged to the active ProfileScope (paste Profiler.cpp
+above this) for the current turn, and turns are closed by Profiler::endTurn(). Once
+stdin has closed, the report names the turn with the most allocations, its peak live
+bytes, and the phases responsible. Without the switch, this compiles to nothing.
+
+*/
+
+#ifdef ALLOC_PROFILE
+
+namespace AllocProfile {
+  struct Counts {
+    long allocs = 0;
+    long bytes = 0;
+  };
+
+  struct Turn {
+    int number = 0;
+    Counts total;
+    long peakLive = 0;
+    Counts byPhase[Profiler::MAX_PHASES + 1];   // [0] is outside any phase
+  };
+
+  inline Turn now;
+  inline Turn worst;
+  inline long live = 0;
+
+  inline void record(size_t bytes) {
+    now.total.allocs += 1;
+    now.total.bytes += bytes;
+    live += bytes;
+    now.peakLive = max(now.peakLive, live);
+
+    Counts &phase = now.byPhase[Profiler::current + 1];
+    phase.allocs += 1;
+    phase.bytes += bytes;
+  }
+
+  inline void report() {
+    cerr << "Worst turn for allocations: turn " << worst.number << ", "
+      << worst.total.allocs << " allocs, " << worst.total.bytes << " bytes, "
+      << worst.peakLive << " peak live bytes" << endl;
+
+    // Phases from most allocations to least; a selection sort over a handful is fine
+    bool shown[Profiler::MAX_PHASES + 1] = {};
+    for (int rank = 0; rank <= Profiler::MAX_PHASES; ++rank) {
+      int top = -1;
+      for (int i = 0; i <= Profiler::MAX_PHASES; ++i)
+        if (!shown[i] && worst.byPhase[i].allocs > 0
+            && (top < 0 || worst.byPhase[i].allocs > worst.byPhase[top].allocs))
+          top = i;
+      if (top < 0)
+        break;
+
+      shown[top] = true;
+      cerr << "  " << Profiler::nameOf(top - 1) << ": "
+        << worst.byPhase[top].allocs << " allocs, "
+        << worst.byPhase[top].bytes << " bytes" << endl;
     }
+  }
 
+  inline void closeTurn() {
+    if (now.total.allocs > worst.total.allocs)
+      worst = now;
 
-    /** Returns a list of <p,i> pairs where p is the intersection between the line A→B
-     * and a side of this polygon, and i is the index of I for a polygon side described
-     * by the line segment I→I+1.
-     * 
-     * The size of the returned list will be in the range [0,2].  
-     * 0 if the line does not intersect; 1 if it does, but only as tangent to a vertex;
-     * and 2 otherwise.
-     * 
-     * Due to implementation, a line A→B does not 'intersect' with I→I+1 at all if they
-     * describe the same linecast. */
-    vector<pair<Point, int>> intersectsFromLine(const Point &A, const Point &B) const {
-        vector<pair<Point, int>> intersects;
+    int number = now.number;
+    now = Turn();
+    now.number = number + 1;
+    now.peakLive = live;
+  }
 
-        Line line_cast(A,B);
+  inline bool installed = [] {
+    Profiler::onTurnEnd = closeTurn;
+    Profiler::reporters[Profiler::reporterCount++] = report;
+    return true;
+  }();
+}
 
-        cerr << "getting intersections" << endl;
+// Each block carries its size in a header, so delete can keep the live count right.
+// Kept out of line; inlined into containers, GCC mistakes the header offset for a bug.
+const size_t ALLOC_HEADER = alignof(max_align_t);
+
+__attribute__((noinline)) void* operator new(size_t bytes) {
+  void* block = malloc(bytes + ALLOC_HEADER);
+  if (!block)
+    throw bad_alloc();
+  *static_cast<size_t*>(block) = bytes;
+  AllocProfile::record(bytes);
+  return static_cast<char*>(block) + ALLOC_HEADER;
+}
 
-        // Find intersections
-        for (int i = 0; i < vertices.size(); ++i) {
-            int j = (i + 1) % vertices.size();
-            
-            Point I = *(vertices.begin() + i);
-            Point J = *(vertices.begin() + j);
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  if (!p)
+    return;
+  void* block = static_cast<char*>(p) - ALLOC_HEADER;
+  AllocProfile::live -= *static_cast<size_t*>(block);
+  free(block);
+}
 
-            cerr << "checking side " << string(I) << " -> " << string(J);
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
 
-            Line poly_side(I,J);
+#endif
 
-            optional<Point> intersect = poly_side.intersection(line_cast);
+/* Hardware performance counters
 
-            if (!intersect) {
-              cerr << " : lines do not intersect; skipping" << endl;
-              continue;
-            }
+Compile with -DPERF_COUNTERS on Linux to sample cycles, instructions, L1 data read
+misses, last-level cache misses and branch misses around every ProfileScope (paste
+Profiler.cpp above this). Counts are inclusive of nested phases. The report, printed
+by Profiler::endTurn() once stdin closes, gives each phase's IPC and misses per
+thousand instructions. Low IPC with high cache MPKI means a phase is waiting on memory;
+high branch MPKI means it's mispredicting.
 
-            cerr << " X " << string(*intersect);
+Needs perf_event_paranoid <= 2, or CAP_PERFMON, and won't work on the CodinGame
+servers; it's for local runs against recorded inputs. Without the switch, this
+compiles to nothing.
 
-            if (intersect == J) {   // intersection occurs over a polySide endpoint,
-                cerr << " : potential duplicate; skipping" << endl;
-                continue;           // so only accept one endpoint to exclude duplicates.
-            }
+*/
 
-            if (poly_side.pointInSegment(*intersect)) {
-                intersects.push_back(pair(*intersect, i));
-                cerr << " : accepted";
-            }
-            else
-                cerr << " : not in range; skipping";
+#ifdef PERF_COUNTERS
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace PerfCounters {
+  const int EVENTS = 5;
+  enum Event { Cycles, Instructions, L1Misses, LlcMisses, BranchMisses };
+
+  const int MAX_DEPTH = 16;
+
+  inline int fds[EVENTS] = {-1, -1, -1, -1, -1};
+  inline uint64_t totals[Profiler::MAX_PHASES][EVENTS];
+  inline uint64_t entered[MAX_DEPTH][EVENTS];   // Samples taken at each open scope
+  inline int depth = 0;
+
+  inline int openEvent(uint32_t type, uint64_t config, int group) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group < 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+  }
+
+  /** Reads all five counters with one syscall. */
+  inline bool sample(uint64_t out[EVENTS]) {
+    uint64_t buffer[1 + EVENTS];    // count, then values
+    if (read(fds[0], buffer, sizeof(buffer)) != sizeof(buffer))
+      return false;
+    memcpy(out, buffer + 1, sizeof(uint64_t) * EVENTS);
+    return true;
+  }
+
+  inline void enter(int /* phase */) {   // Totals are attributed on exit
+    if (depth < MAX_DEPTH)
+      sample(entered[depth]);
+    ++depth;
+  }
+
+  inline void exit(int phase) {
+    --depth;
+    uint64_t now[EVENTS];
+    if (depth >= MAX_DEPTH || !sample(now))
+      return;
+    for (int e = 0; e < EVENTS; ++e)
+      totals[phase][e] += now[e] - entered[depth][e];
+  }
+
+  inline void report() {
+    cerr << "Phase counters:" << endl;
+    cerr << "  " << setw(24) << left << "phase" << right
+      << setw(14) << "cycles" << setw(7) << "IPC"
+      << setw(9) << "L1 MPKI" << setw(10) << "LLC MPKI" << setw(10) << "br MPKI" << endl;
+
+    for (int i = 0; i < Profiler::phaseCount; ++i) {
+      const uint64_t* t = totals[i];
+      double kiloInstructions = max<uint64_t>(t[Instructions], 1) / 1000.0;
+      cerr << "  " << setw(24) << left << Profiler::phases[i].name << right
+        << setw(14) << t[Cycles]
+        << fixed << setprecision(2)
+        << setw(7) << double(t[Instructions]) / max<uint64_t>(t[Cycles], 1)
+        << setw(9) << t[L1Misses] / kiloInstructions
+        << setw(10) << t[LlcMisses] / kiloInstructions
+        << setw(10) << t[BranchMisses] / kiloInstructions << endl;
+    }
+  }
+
+  /** Opens the counter group and installs the profiler hooks; runs at startup. */
+  inline bool start() {
+    const uint64_t l1ReadMiss = PERF_COUNT_HW_CACHE_L1D
+      | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    fds[Cycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    fds[Instructions] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[0]);
+    fds[L1Misses] = openEvent(PERF_TYPE_HW_CACHE, l1ReadMiss, fds[0]);
+    fds[LlcMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, fds[0]);
+    fds[BranchMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, fds[0]);
+
+    for (int e = 0; e < EVENTS; ++e) {
+      if (fds[e] >= 0)
+        continue;
+      cerr << "PerfCounters: perf_event_open failed (" << strerror(errno) << "); disabled" << endl;
+      for (int f = 0; f < EVENTS; ++f)
+        if (fds[f] >= 0)
+          close(fds[f]);
+      return false;
+    }
+
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    Profiler::onEnter = enter;
+    Profiler::onExit = exit;
+    Profiler::reporters[Profiler::reporterCount++] = report;
+    return true;
+  }
+
+  inline bool started = start();
+}
+
+#endif
+
+/** The points p with normal·p <= offset: one side of a line, edge included. */
+struct HalfPlane {
+    Point normal;
+    double offset;
+
+    /** The cells strictly nearer to `near` than to `far`, bisector excluded: what a
+     * WARMER clue leaves when jumping from far to near, or a COLDER one when jumping
+     * from near to far. For integer points, normal·p is a whole number and the closed
+     * offset a multiple of ½, so moving the edge in by ½ leaves exactly those cells. */
+    static HalfPlane nearerTo(const Point &near, const Point &far) {
+        HalfPlane plane = noFartherFrom(near, far);
+        plane.offset -= 0.5;
+        return plane;
+    }
+
+    /** The points at least as near to `near` as to `far`, bisector included. A SAME clue
+     * leaves this and its mirror image, which is the bisector alone. */
+    static HalfPlane noFartherFrom(const Point &near, const Point &far) {
+        // |p - near|^2 <= |p - far|^2  <=>  p·(far - near) <= (|far|^2 - |near|^2) / 2
+        Point normal = far - near;
+        double offset = (far.x*far.x + far.y*far.y - near.x*near.x - near.y*near.y) / 2;
+        return {normal, offset};
+    }
+
+    /** How far past the edge p is, scaled by |normal|; positive outside, negative inside. */
+    double excess(const Point &p) const {
+        return normal.x*p.x + normal.y*p.y - offset;
+    }
 
-            cerr << endl;
+    bool contains(const Point &p) const {
+        return excess(p) <= 0;
+    }
+
+    operator string() const {
+        stringstream s;
+        s << fixed << setprecision(3)
+          << "[" << normal.x << "x + " << normal.y << "y <= " << offset << "]";
+        return s.str();
+    }
+};
+
+class Polygon {
+    vector<Point> vertices;
+
+public:
+
+    Polygon(const vector<Point> &points) : vertices(points) {
+        // Check that each point is unique?
+    }
+
+    int size() const { return vertices.size(); }
+    const Point& operator[](int i) const { return vertices[i]; }
+
+    /** Returns the part of this convex polygon inside the half-plane; one pass of
+     * Sutherland–Hodgman. The result may be empty, or flat if the edge lies along it.
+     * Vertices within a hair of the edge count as on it, so that clipping a flat polygon
+     * by the edge it lies along (a SAME clue's second cut) doesn't lose its rounded
+     * intersection points. Cells sit at least ½ from a clue's edge, or exactly on it. */
+    Polygon clip(const HalfPlane &plane) const {
+        const double slack = 1e-6;
+        vector<Point> kept;
+        kept.reserve(vertices.size() + 1);
+
+        for (int i = 0; i < size(); ++i) {
+            const Point &I = vertices[i];
+            const Point &J = vertices[(i + 1) % size()];
+            double inI = plane.excess(I), inJ = plane.excess(J);
+
+            if (inI <= slack)
+                kept.push_back(I);
+            if ((inI < -slack && inJ > slack) || (inI > slack && inJ < -slack))
+                kept.push_back(I + (J - I) * (inI / (inI - inJ)));
         }
+        return Polygon(kept);
+    }
 
-        // Debug report
-        cerr << "Found " << intersects.size() << " intersections for line " << string(line_cast) << endl;
-        for (auto &p : intersects)
-            cerr << string(p.first) << " , ";
-        cerr << endl;
-
-        return intersects;
-    }
-
-    /** Split this polygon about the line A→B and return the two resulting shapes on either side.  
-     * If the line A→B does not sufficiently bisect this polygon, then only itself shall be returned. */
-    vector<Polygon> slice(const Point &A, const Point &B) const {
-        auto intersects = intersectsFromLine(A,B);
-        
-        if (intersects.size() < 2)
-            return vector<Polygon>( {*this} );
-
-        if (intersects.size() > 2) {
-            cerr << endl;
-            for (auto &p : intersects)
-                cerr << string(p.first) << ", ";
-            cerr << endl;
-            throw invalid_argument("This shouldn't happen. Intersections through a convex(?) shape were > 2.");
+    /** A row's worth of the integer points inside a convex polygon: (first..last, y). */
+    struct RowSpan {
+        int y;
+        int first;
+        int last;
+    };
+
+    /** Returns, for each row with integer points inside this convex polygon and within
+     * [0, maxX] x [0, maxY], the first and last of them. Costs O(rows * sides). */
+    vector<RowSpan> rowSpans(int maxX, int maxY) const {
+        vector<RowSpan> spans;
+        if (vertices.empty())
+            return spans;
+
+        double low = vertices[0].y, high = vertices[0].y;
+        for (auto &p : vertices) {
+            low = min(low, p.y);
+            high = max(high, p.y);
         }
 
-        // Setup
-        Point pA = intersects[0].first;
-        Point pB = intersects[1].first;
+        const double slack = 1e-9;
+        for (int y = max(0, int(ceil(low - slack))); y <= min(maxY, int(floor(high + slack))); ++y) {
+            double left = INFINITY, right = -INFINITY;
+            for (int i = 0; i < size(); ++i) {
+                const Point &I = vertices[i];
+                const Point &J = vertices[(i + 1) % size()];
+                if (y < min(I.y, J.y) - slack || y > max(I.y, J.y) + slack)
+                    continue;
+                if (abs(J.y - I.y) < slack) {
+                    left = min({left, I.x, J.x});
+                    right = max({right, I.x, J.x});
+                    continue;
+                }
+                double x = I.x + (J.x - I.x) * (y - I.y) / (J.y - I.y);
+                left = min(left, x);
+                right = max(right, x);
+            }
 
-        int idxA = intersects[0].second;
-        int idxB = intersects[1].second;
+            int first = max(0, int(ceil(left - slack)));
+            int last = min(maxX, int(floor(right + slack)));
+            if (first <= last)
+                spans.push_back({y, first, last});
+        }
+        return spans;
+    }
 
-        auto begin = vertices.begin();
-        auto end = vertices.end();
-        auto itA = begin + min(idxA, idxB);
-        auto itB = begin + max(idxA, idxB);
+    /** Returns the convex hull of the integer points inside this convex polygon and within
+     * [0, maxX] x [0, maxY]; empty if there are none. Only each row's end points can be
+     * corners, so this is O(rows * sides) rather than O(area). */
+    Polygon latticeHull(int maxX, int maxY) const {
+        // Row ends in (y, x) order, which is all monotone chain needs
+        vector<Point> ends;
+        for (auto &span : rowSpans(maxX, maxY)) {
+            ends.push_back(Point(span.first, span.y));
+            if (span.last != span.first)
+                ends.push_back(Point(span.last, span.y));
+        }
 
-        // All vertices pA→pB
-        vector<Point> shapeA(itA+1, itB+1);
-        if (*(shapeA.end()-1) != pB)
-            shapeA.insert(shapeA.end(), {pB});
-        if (*(shapeA.begin()) != pA)
-            shapeA.insert(shapeA.end(), {pA});
+        if (ends.size() <= 2)
+            return Polygon(ends);
 
-        // All vertices pB→pA
-        vector<Point> shapeB(begin, itA+1);
-        if (*(shapeB.end()) != pA)
-            shapeB.insert(shapeB.end(), {pA});
-        if (*(itB+1) != pB)
-            shapeB.insert(shapeB.end(), {pB});
-        shapeB.insert(shapeB.end(), itB+1, end);
+        // Andrew's monotone chain; collinear points are dropped
+        vector<Point> hull(2 * ends.size());
+        int k = 0;
+        auto turnsLeft = [](const Point &O, const Point &A, const Point &B) {
+            return (A - O).crossZ(B - O) > 0;
+        };
+        for (int i = 0; i < int(ends.size()); ++i) {
+            while (k >= 2 && !turnsLeft(hull[k-2], hull[k-1], ends[i]))
+                --k;
+            hull[k++] = ends[i];
+        }
+        for (int i = ends.size() - 2, lower = k + 1; i >= 0; --i) {
+            while (k >= lower && !turnsLeft(hull[k-2], hull[k-1], ends[i]))
+                --k;
+            hull[k++] = ends[i];
+        }
+        hull.resize(k - 1);
+        return Polygon(hull);
+    }
 
-        return vector<Polygon>( {Polygon(shapeA), Polygon(shapeB)} );
+    /** Returns the integer points inside this convex polygon and within [0, maxX] x
+     * [0, maxY], row by row; stops once there are more than `limit` of them. */
+    vector<Point> latticePoints(int maxX, int maxY, int limit) const {
+        vector<Point> points;
+        for (auto &span : rowSpans(maxX, maxY))
+            for (int x = span.first; x <= span.last; ++x) {
+                points.push_back(Point(x, span.y));
+                if (int(points.size()) > limit)
+                    return points;
+            }
+        return points;
+    }
+
+    /** Returns the enclosed area, by the shoelace formula. */
+    double area() const {
+        double twice = 0;
+        for (int i = 0; i < size(); ++i)
+            twice += vertices[i].crossZ(vertices[(i + 1) % size()]);
+        return abs(twice) / 2;
     }
 
     /** Returns a Point: an approximation of the polygon's center. */
@@ -342,6 +901,36 @@ public:
         return sum / vertices.size();
     }
 
+    /** Returns `from` mirrored through this polygon's centre; the cut between the two
+     * runs through the centre, so it halves the polygon. */
+    Point reflect(const Point &from) const {
+        Point center = averageVertex();
+        return center - (from - center);
+    }
+
+    /** Returns `from` turned by `angle` radians about this polygon's centre. The cut
+     * between the two also runs through the centre, at its own angle; reflect() is the
+     * half turn. */
+    Point turn(const Point &from, double angle) const {
+        Point center = averageVertex();
+        Point offset = from - center;
+        return center + Point(
+            offset.x * cos(angle) - offset.y * sin(angle),
+            offset.x * sin(angle) + offset.y * cos(angle));
+    }
+
+    /** Whether a jump from `from` to `to` would get different clues for different cells
+     * of this polygon, taken to be their lattice hull: false if every corner, and so every
+     * cell, is on the same side of the cut or on it. */
+    bool splits(const Point &from, const Point &to) const {
+        HalfPlane warmerCut = HalfPlane::nearerTo(to, from);
+        HalfPlane colderCut = HalfPlane::nearerTo(from, to);
+        bool warmer = false, colder = false, same = false;
+        for (auto &p : vertices)
+            (warmerCut.contains(p) ? warmer : colderCut.contains(p) ? colder : same) = true;
+        return warmer + colder + same > 1;
+    }
+
     /** Returns a new Polygon: a rectangle which contains all the area this polygon does. */
     Polygon boundingRect() const {
         double left, right, top, bottom;
@@ -371,18 +960,159 @@ public:
     }
 };
 
+/** The search region, kept as the building's box plus one half-plane per clue. The
+ * polygon is only worked out when something asks for it (for a pivot, an area, ...),
+ * one clip per constraint, and each prefix's polygon is kept until its constraints
+ * change. So a candidate jump can be tried by push()ing its cut, asking for the area,
+ * and pop()ping it again, which costs one clip and copies nothing else. */
+class Region {
+    vector<HalfPlane> constraints;
+    mutable vector<Polygon> shapes;     // shapes[i]: the box cut by the first i constraints
+
+public:
+
+    Region(double width, double height)
+    : shapes({Polygon({
+        Point(),
+        Point(width, 0),
+        Point(width, height),
+        Point(0, height)})})
+    { }
+
+    void push(const HalfPlane &plane) {
+        constraints.push_back(plane);
+    }
+
+    void pop() {
+        constraints.pop_back();
+        if (shapes.size() > constraints.size() + 1)
+            shapes.pop_back();
+    }
+
+    const Polygon& polygon() const {
+        if (shapes.size() <= constraints.size()) {
+            ProfileScope scope("Region::polygon");
+            while (shapes.size() <= constraints.size())
+                shapes.push_back(shapes.back().clip(constraints[shapes.size() - 1]));
+        }
+        return shapes.back();
+    }
+
+    /** Shrinks the region to the convex hull of the cells in it. The bomb is on a cell,
+     * so slivers between cells are dead space, and the pivot shouldn't drift into them.
+     * The hull stands in for the current polygon until the last constraint is popped. */
+    void tighten(int maxX, int maxY) {
+        ProfileScope scope("Region::tighten");
+        Polygon hull = polygon().latticeHull(maxX, maxY);
+        if (hull.size() > 0)
+            shapes.back() = hull;
+    }
+
+    bool empty() const { return polygon().size() == 0; }
+    double area() const { return polygon().area(); }
+
+    operator string() const {
+        return string(polygon());
+    }
+};
+
+
+/** Exact play for the last few cells. Once the region holds only a handful, this works
+ * out by exhaustive minimax which jump finds the bomb in the fewest turns whatever the
+ * clues turn out to be. Jumps are drawn from the cells themselves and their neighbours,
+ * which is enough to split any few cells apart. */
+class Endgame {
+public:
+    static const int MAX_CELLS = 6;
+
+    Endgame(const vector<Point> &cells, const Point &pos, int width, int height)
+    : cells(cells)
+    {
+        for (auto &cell : cells)
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx) {
+                    Point jump(cell.x + dx, cell.y + dy);
+                    bool onBuilding = within(jump.x, 0, width - 1) && within(jump.y, 0, height - 1);
+                    if (onBuilding && find(jumps.begin(), jumps.end(), jump) == jumps.end())
+                        jumps.push_back(jump);
+                }
+        start = find(jumps.begin(), jumps.end(), pos) - jumps.begin();
+        if (start == int(jumps.size()))
+            jumps.push_back(pos);
+
+        memo.assign((size_t(1) << cells.size()) * jumps.size(), -1);
+    }
+
+    /** Returns the jump to make from pos, or nothing if no sequence of the candidate
+     * jumps is sure to find the bomb. */
+    optional<Point> bestJump() {
+        ProfileScope scope("Endgame::bestJump");
+        int full = (1 << cells.size()) - 1;
+        int bestTurns = INT8_MAX, best = start;
+        for (int j = 0; j < int(jumps.size()); ++j) {
+            int turns = turnsVia(full, start, j);
+            if (turns < bestTurns) {
+                bestTurns = turns;
+                best = j;
+            }
+        }
+        if (bestTurns == INT8_MAX)
+            return nullopt;
+        cerr << "endgame: " << cells.size() << " cells, " << bestTurns << " turns at most" << endl;
+        return jumps[best];
+    }
+
+private:
+    vector<Point> cells;
+    vector<Point> jumps;
+    int start;
+    vector<int8_t> memo;    // [mask][from]: worst-case turns left
+
+    /** Worst-case turns to land on the bomb, somewhere among the cells in `mask`, if the
+     * next jump is from `from` to `to`; INT8_MAX if that jump can't tell them apart. The
+     * cells are split by the same cuts main() makes for each clue. */
+    int turnsVia(int mask, int from, int to) {
+        if (to == from)
+            return INT8_MAX;
+
+        HalfPlane warmerCut = HalfPlane::nearerTo(jumps[to], jumps[from]);
+        HalfPlane colderCut = HalfPlane::nearerTo(jumps[from], jumps[to]);
+        int warmer = 0, colder = 0, same = 0;
+        for (int b = 0; b < int(cells.size()); ++b) {
+            if (!(mask >> b & 1) || cells[b] == jumps[to])
+                continue;
+            (warmerCut.contains(cells[b]) ? warmer : colderCut.contains(cells[b]) ? colder : same) |= 1 << b;
+        }
+        if (warmer == mask || colder == mask || same == mask)
+            return INT8_MAX;
+
+        int worst = 0;
+        for (int part : {warmer, colder, same})
+            if (part)
+                worst = max(worst, turnsLeft(part, to));
+        return (worst == INT8_MAX) ? INT8_MAX : 1 + worst;
+    }
+
+    /** Worst-case turns to land on the bomb, somewhere among the cells in `mask`, from `from`. */
+    int turnsLeft(int mask, int from) {
+        int8_t &known = memo[size_t(mask) * jumps.size() + from];
+        if (known >= 0)
+            return known;
+
+        int best = INT8_MAX;
+        for (int j = 0; j < int(jumps.size()) && best > 1; ++j)
+            best = min(best, turnsVia(mask, from, j));
+        return known = best;
+    }
+};
+
 
 int main()
 {
     int width, height;
     cin >> width >> height; cin.ignore();
 
-    Polygon search({
-        Point(),
-        Point(width, 0),
-        Point(width, height),
-        Point(0, height)}
-    );
+    Region search(width, height);
 
     int n; // maximum number of turns before game over.
     cin >> n; cin.ignore();
@@ -395,89 +1125,106 @@ int main()
     string bomb_clue;
     cin >> bomb_clue; cin.ignore();     // dispose of 'UNKNOWN'
 
+    CommandWriter out;
+    Watchdog watchdog;
+    watchdog.startTurn();
+
+    // Each turn's fallback is the plain reflection about the search space, armed before
+    // the region is tightened or the endgame searched
+    auto armReflection = [&]() {
+        Point jump = search.polygon().reflect(pos).apply(floor);
+        out << int(clamp(jump.x, 0, width-1)) << ' ' << int(clamp(jump.y, 0, height-1)) << '\n';
+        watchdog.arm(out, TURN_TIMEOUT_MS);
+        out.clear();
+    };
+    armReflection();
+
 
     // game loop
     while (1) {
         // Record position pre-movement
         lastPos = pos;
 
-        // Reflect about the search space
-        Point search_center = search.averageVertex();
-        pos = search_center - (pos - search_center);
+        // Reflect about the search space, until few enough cells are left to play exactly
+        Point search_center = search.polygon().averageVertex();
+        vector<Point> cells;
+        if (search.area() <= Endgame::MAX_CELLS)
+            cells = search.polygon().latticePoints(width - 1, height - 1, Endgame::MAX_CELLS);
 
-        pos = pos.apply(floor);
-        pos.x = clamp(pos.x, 0, width-1);
-        pos.y = clamp(pos.y, 0, height-1);
+        optional<Point> exact;
+        if (!cells.empty() && cells.size() <= Endgame::MAX_CELLS)
+            exact = Endgame(cells, pos, width, height).bestJump();
+
+        if (exact)
+            pos = *exact;
+        else {
+            // The reflection's cut runs square to the line from us to the centre; a thin
+            // region lying along that line, such as the segment a SAME clue leaves, can
+            // have every cell on one side of it once it's rounded. Then try the other
+            // roundings, then turns ever further from a half turn, whose cuts still run
+            // through the centre but cross the region aslant.
+            const Polygon &region = search.polygon();
+            vector<Point> jumps;
+            for (int step = 0; step < PIVOT_STEPS; ++step)
+                for (int side : {1, -1}) {
+                    if (step == 0 && side < 0)
+                        continue;
+                    Point target = region.turn(lastPos, M_PI + side * step * M_PI / PIVOT_STEPS);
+                    for (double x : {floor(target.x), ceil(target.x)})
+                        for (double y : {floor(target.y), ceil(target.y)})
+                            jumps.push_back(Point(clamp(x, 0, width-1), clamp(y, 0, height-1)));
+                }
+
+            pos = jumps[0];
+            auto splitting = find_if(jumps.begin(), jumps.end(),
+                [&](const Point &jump) { return region.splits(lastPos, jump); });
+            if (splitting != jumps.end())
+                pos = *splitting;
+        }
+
+        // Landing where we stand would only hear SAME again; step a cell over instead
+        if (pos == lastPos) {
+            if (width > 1)
+                pos.x += (pos.x + 1 < width) ? 1 : -1;
+            else
+                pos.y += (pos.y + 1 < height) ? 1 : -1;
+        }
 
         cerr << "search: " << string(search) << endl;
         cerr << "search pivot: " << string(search_center) << endl;
         cerr << "move: " << string(lastPos) << " -> " << string(pos) << endl;
 
         // Yield move instruction
-        cout << int(pos.x) << " " << int(pos.y) << endl;
+        out << int(pos.x) << ' ' << int(pos.y) << '\n';
+        watchdog.finish(out);
+
+        if (Profiler::endTurn())
+            return 0;
 
         // Recieve next clue
         cin >> bomb_clue; cin.ignore();
+        watchdog.startTurn();
 
-        if (bomb_clue == "SAME") {
-            cerr << "Clue was 'SAME'; I don't have a protocol for this." << endl;
-            continue;
-
-            // TODO Finally! I think.
-            // My polygon algorithm finally narrows down on the target.
-            // But now it doesn't know what to do when the distance doesn't change,
-            // which means I need to slice the search by the midline.
-            // 
-            // I suspect doing so wouldn't change the pivot point, however.
-            // Where does batman jump to?
-            // I mean, narrowed or not, I never came up with an endgame;
-            // even if the search polygon was 1 square, batman will orbit around
-            // it forever.
-            //
-            // Funnily, Batman does narrow in on his own.
-            // I think this is because of the bounds of the building, though;
-            // like, he can't always jump to where he wants to.
-            
-            // Probably what I should do is slice about the midline, and then
-            // position batman on next jump at the end of that midline, so he
-            // can finish up in linear fashion.
-        }
-
-        // Narrow the search space about the reflection line
-        Point mid = ((pos - lastPos) / 2.0 + lastPos).apply(floor);
-        Point midB = (pos - mid).rotateByComplex(Point(0,1)) + mid;   // mid→midB is perpendicular to pos→lastPos
-
-        cerr << "last = " << string(lastPos) << " -> " << string(pos) << endl;
-        cerr << "lastline = " << string(Line(lastPos, pos)) << endl;
-        cerr << "midpoint = " << string(mid) << " ( & " << string(midB) << " )" << endl;
-        cerr << "midline = " << string(Line(mid, midB)) << endl;
-
-        auto shapes = search.slice(mid, midB);
-
-        // Something happened to the midline — wasn't sufficiently through the search polygon
-        if (shapes.size() < 2)
-            continue;
-
-        Polygon warm = shapes[0];
-        Polygon cold = shapes[1];
-
-        if (warm.averageVertex().distanceTo(pos) > cold.averageVertex().distanceTo(pos)) {
-            cold = shapes[0];
-            warm = shapes[1];
+        // Narrow the search space to the side of the bisector the clue points at
+        if (bomb_clue == "WARMER")
+            search.push(HalfPlane::nearerTo(pos, lastPos));
+        else if (bomb_clue == "COLDER")
+            search.push(HalfPlane::nearerTo(lastPos, pos));
+        else {
+            // SAME: the bomb is on the bisector itself, so the region goes flat
+            search.push(HalfPlane::noFartherFrom(pos, lastPos));
+            search.push(HalfPlane::noFartherFrom(lastPos, pos));
         }
 
-        cerr << "warm = " << string(warm) << endl;
-        cerr << "cold = " << string(cold) << endl;
-
-        if (bomb_clue == "WARMER") {
-            search = warm;
-            cerr << "chose warm" << endl;
+        // Rounding can leave a clue disagreeing with a sliver of a region; drop it
+        while (search.empty()) {
+            cerr << "clue emptied the search; ignoring it" << endl;
+            search.pop();
         }
-        else {
-            search = cold;
-            cerr << "chose cold" << endl;
-        };
+        armReflection();
+        search.tighten(width - 1, height - 1);
 
+        cerr << "clue " << bomb_clue << ": " << string(search) << endl;
         cerr << endl; // newline to separate search-narrow alg from next move calc
     }
-}
\ No newline at end of file
+}
@@ -4,8 +4,12 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <tuple>
 #include <cmath>
 
+#include <cstring>
+#include <unistd.h>
+
 using namespace std;
 
 /* Observations
@@ -19,6 +23,8 @@ I can still use rectangles in this case.
 
 [In fact, that's the solution I'm using here ↓]
 
+[Update: it now picks an axis every turn instead; see the game loop.]
+
 TODO This method suffers some redundancies.
 It alternates between the left and right edges of the search area, so
 when it moves to the other side, but the clue is colder, the area shrinks
@@ -107,6 +113,100 @@ public:
     }
 };
 
+/** Builds a turn's output in a buffer and hands it to the OS with one write() call; no
+ * iostreams, locales or per-line flushes. Integers are formatted two digits at a time
+ * from a lookup table. The buffer grows rather than flushing early, so nothing reaches
+ * stdout before flush(); the Watchdog relies on that to discard a late answer.
+ *
+ *   out << "MOVE " << x << ' ' << y << '\n';
+ *   out.flush();   // once, after the turn's last command
+ *
+ * Don't mix with cout in the same bot; the two buffers would interleave. */
+class CommandWriter {
+    vector<char> buffer = vector<char>(4096);
+    int length = 0;
+
+    void reserve(int n) {
+        if (length + n > int(buffer.size()))
+            buffer.resize(max<size_t>(buffer.size() * 2, length + n));
+    }
+
+public:
+
+    CommandWriter& operator<<(char c) {
+        reserve(1);
+        buffer[length++] = c;
+        return *this;
+    }
+
+    CommandWriter& operator<<(const char* s) {
+        int n = strlen(s);
+        reserve(n);
+        memcpy(buffer.data() + length, s, n);
+        length += n;
+        return *this;
+    }
+
+    CommandWriter& operator<<(const string &s) {
+        reserve(s.size());
+        memcpy(buffer.data() + length, s.data(), s.size());
+        length += s.size();
+        return *this;
+    }
+
+    CommandWriter& operator<<(int n) {
+        static const char digitPairs[] =
+            "00010203040506070809" "10111213141516171819" "20212223242526272829"
+            "30313233343536373839" "40414243444546474849" "50515253545556575859"
+            "60616263646566676869" "70717273747576777879" "80818283848586878889"
+            "90919293949596979899";
+
+        reserve(11);
+        unsigned int u = (n < 0) ? 0u - unsigned(n) : unsigned(n);
+        if (n < 0)
+            buffer[length++] = '-';
+
+        char digits[10];
+        int i = 10;
+        while (u >= 100) {
+            int pair = (u % 100) * 2;
+            u /= 100;
+            digits[--i] = digitPairs[pair + 1];
+            digits[--i] = digitPairs[pair];
+        }
+        if (u >= 10) {
+            digits[--i] = digitPairs[u * 2 + 1];
+            digits[--i] = digitPairs[u * 2];
+        }
+        else
+            digits[--i] = '0' + u;
+
+        memcpy(buffer.data() + length, digits + i, 10 - i);
+        length += 10 - i;
+        return *this;
+    }
+
+    const char* data() const { return buffer.data(); }
+    int size() const { return length; }
+
+    /** Discards everything buffered. */
+    void clear() {
+        length = 0;
+    }
+
+    /** Writes everything buffered to stdout. */
+    void flush() {
+        int written = 0;
+        while (written < length) {
+            int n = write(STDOUT_FILENO, buffer.data() + written, length - written);
+            if (n <= 0)
+                break;
+            written += n;
+        }
+        length = 0;
+    }
+};
+
 struct Rect {
     double left = 0.0;
     double top = 0.0;
@@ -125,6 +225,8 @@ int main()
 {
     Rect search;
     cin >> search.right >> search.bottom; cin.ignore();
+    const double buildingWidth = search.right;
+    const double buildingHeight = search.bottom;
 
     int n; // maximum number of turns before game over.
     cin >> n; cin.ignore();
@@ -137,21 +239,69 @@ int main()
     string bomb_clue;
     cin >> bomb_clue; cin.ignore();     // dispose of 'UNKNOWN'
 
-    bool xfound = (search.left + 1 == search.right);
-    bool nearSide = false;
-
+    CommandWriter out;
+
+    // Function which gets new search-space limits for an axis
+    auto getNewLimits = [](double mid, double travel, string clue, double min, double max) {
+      cerr << "checking " << mid << " " << travel << " " << clue << endl;
+      double lo = min, hi = max;
+      if (clue == "SAME") {
+        min = mid;
+        max = mid + 1;
+      } else if ((travel > 0 && clue == "WARMER") || (travel < 0 && clue == "COLDER"))
+        min = mid + 1;
+      else
+        max = mid;
+
+      // A jump that doesn't straddle the search space mustn't widen it again
+      min = ::max(lo, floor(min));
+      max = ::min(hi, ceil(max));
+      cerr << "new bounds = " << min << " , " << max << endl;
+      return make_tuple(min, max);
+    };
+
+    // The most cells [min, max) could still hold after a jump from -> to along one axis
+    auto worstLeft = [](double from, double to, double min, double max) {
+      double mid = (from + to) / 2;
+      double cells = max - min;
+      double below = clamp(ceil(mid) - min, 0, cells);          // cells < mid
+      double above = clamp(max - (floor(mid) + 1), 0, cells);   // cells > mid
+      double same = cells - below - above;
+      double nearer = (to > from) ? above : below;
+      double farther = (to > from) ? below : above;
+      return ::max({nearer, farther, same});
+    };
+
+    // Reflect about the middle of [min, max), as near as the building allows
+    auto jumpFor = [](double from, double min, double max, double limit) {
+      double to = clamp(min + max - 1 - from, 0, limit - 1);
+      if (to == from)
+        to = (from + 1 < limit) ? from + 1 : from - 1;
+      return to;
+    };
 
     // game loop
     while (1) {
         // Record position pre-movement
         lastPos = pos;
 
-        // Get new position and derivative points
-        nearSide = !nearSide;
-        if (!xfound) {
-          pos.x = (nearSide) ? search.left : search.right-1;
+        // Jump along whichever axis leaves the least area in the worst case. A jump
+        // along one axis says nothing about the other, so neither axis ever needs a
+        // turn spent lining up; the last jump lands on both at once.
+        double width = search.right - search.left;
+        double height = search.bottom - search.top;
+        bool useX;
+
+        if (width <= 1 && height <= 1) {
+          pos = Point(search.left, search.top);
+          useX = true;
         } else {
-          pos.y = (nearSide) ? search.top : search.bottom-1;
+          Point jumpX(jumpFor(pos.x, search.left, search.right, buildingWidth), pos.y);
+          Point jumpY(pos.x, jumpFor(pos.y, search.top, search.bottom, buildingHeight));
+          double areaX = (width > 1) ? worstLeft(pos.x, jumpX.x, search.left, search.right) * height : INFINITY;
+          double areaY = (height > 1) ? worstLeft(pos.y, jumpY.y, search.top, search.bottom) * width : INFINITY;
+          useX = (areaX <= areaY);
+          pos = useX ? jumpX : jumpY;
         }
 
         travel = pos - lastPos;
@@ -162,54 +312,22 @@ int main()
         cerr << string(lastPos) << " -> " << string(pos) << endl;
         cerr << "mid= " << mid.logStr() << endl;
 
-        cout << int(pos.x) << " " << int(pos.y) << endl;
+        out << int(pos.x) << ' ' << int(pos.y) << '\n';
+        out.flush();
 
         // Get clue, calculate next search bounds
         cin >> bomb_clue; cin.ignore();
 
-        // Function which gets new search-space limits for an axis
-        auto getNewLimits = [](double mid, double travel, string clue, double min, double max) {
-          cerr << "checking " << mid << " " << travel << " " << clue << endl;
-
-          if (clue == "SAME") {
-            min = mid;
-            max = mid + 1;
-          } else if (travel > 0 && clue == "WARMER" || travel < 0 && clue == "COLDER")
-            min = mid + 1;
-          else
-            max = mid;
-          
-          cerr << "new bounds = " << floor(min) << " , " << ceil(max) << endl;
-          return make_tuple(floor(min), ceil(max));
-        };
-
         double nxt_min, nxt_max;
-
-        if (!xfound) {
+        if (travel.x != 0 && useX) {
           tie(nxt_min, nxt_max) = getNewLimits(mid.x, travel.x, bomb_clue, search.left, search.right);
           search.left = nxt_min;
           search.right = nxt_max;
         }
-        else {
+        else if (travel.y != 0) {
           tie(nxt_min, nxt_max) = getNewLimits(mid.y, travel.y, bomb_clue, search.top, search.bottom);
           search.top = nxt_min;
           search.bottom = nxt_max;
         }
-
-        if (!xfound && search.left + 1 == search.right) {
-          cerr << "solved: x = " << search.left << endl;
-
-          // Move into position; discard confusing bomb clue
-          if (pos.x != search.left) {
-              pos.x = search.left;
-              cout << int(pos.x) << " " << int(pos.y) << endl;
-              cin >> bomb_clue; cin.ignore();
-          }
-
-          // Ensure next y-axis move is not to same pos
-          nearSide = (pos.y == search.top);
-
-          xfound = true;
-        }
     }
-}
\ No newline at end of file
+}
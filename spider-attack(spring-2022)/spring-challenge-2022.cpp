@@ -5,7 +5,23 @@
 #include <numeric>
 #include <algorithm>
 #include <cmath>
-#include <map>
+#include <array>
+#include <new>
+#include <stdexcept>
+#include <initializer_list>
+
+#include <cstring>
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
 
 using namespace std;
 
@@ -97,6 +113,755 @@ public:
   }
 };
 
+/** Builds a turn's output in a buffer and hands it to the OS with one write() call; no
+ * iostreams, locales or per-line flushes. Integers are formatted two digits at a time
+ * from a lookup table. The buffer grows rather than flushing early, so nothing reaches
+ * stdout before flush(); the Watchdog relies on that to discard a late answer.
+ *
+ *   out << "MOVE " << x << ' ' << y << '\n';
+ *   out.flush();   // once, after the turn's last command
+ *
+ * Don't mix with cout in the same bot; the two buffers would interleave. */
+class CommandWriter {
+  vector<char> buffer = vector<char>(4096);
+  int length = 0;
+
+  void reserve(int n) {
+    if (length + n > int(buffer.size()))
+      buffer.resize(max<size_t>(buffer.size() * 2, length + n));
+  }
+
+public:
+
+  CommandWriter& operator<<(char c) {
+    reserve(1);
+    buffer[length++] = c;
+    return *this;
+  }
+
+  CommandWriter& operator<<(const char* s) {
+    int n = strlen(s);
+    reserve(n);
+    memcpy(buffer.data() + length, s, n);
+    length += n;
+    return *this;
+  }
+
+  CommandWriter& operator<<(const string &s) {
+    reserve(s.size());
+    memcpy(buffer.data() + length, s.data(), s.size());
+    length += s.size();
+    return *this;
+  }
+
+  CommandWriter& operator<<(int n) {
+    static const char digitPairs[] =
+      "00010203040506070809" "10111213141516171819" "20212223242526272829"
+      "30313233343536373839" "40414243444546474849" "50515253545556575859"
+      "60616263646566676869" "70717273747576777879" "80818283848586878889"
+      "90919293949596979899";
+
+    reserve(11);
+    unsigned int u = (n < 0) ? 0u - unsigned(n) : unsigned(n);
+    if (n < 0)
+      buffer[length++] = '-';
+
+    char digits[10];
+    int i = 10;
+    while (u >= 100) {
+      int pair = (u % 100) * 2;
+      u /= 100;
+      digits[--i] = digitPairs[pair + 1];
+      digits[--i] = digitPairs[pair];
+    }
+    if (u >= 10) {
+      digits[--i] = digitPairs[u * 2 + 1];
+      digits[--i] = digitPairs[u * 2];
+    }
+    else
+      digits[--i] = '0' + u;
+
+    memcpy(buffer.data() + length, digits + i, 10 - i);
+    length += 10 - i;
+    return *this;
+  }
+
+  const char* data() const { return buffer.data(); }
+  int size() const { return length; }
+
+  /** Discards everything buffered. */
+  void clear() {
+    length = 0;
+  }
+
+  /** Writes everything buffered to stdout. */
+  void flush() {
+    int written = 0;
+    while (written < length) {
+      int n = write(STDOUT_FILENO, buffer.data() + written, length - written);
+      if (n <= 0)
+        break;
+      written += n;
+    }
+    length = 0;
+  }
+};
+
+/** Guarantees an answer every turn. The turn's clock starts when its first input is
+ * read. The bot then writes a cheap fallback command into its CommandWriter and arms
+ * the watchdog with it, before any expensive thinking. If finish() hasn't been called
+ * by the deadline, a background thread writes the fallback itself, and whatever the bot
+ * sends later that turn is discarded instead.
+ *
+ *   cin >> ...;                            // the turn's first read; blocks until it arrives
+ *   watchdog.startTurn();
+ *   // read the rest; out << fallback...;
+ *   watchdog.arm(out, TURN_TIMEOUT_MS);    // deadline is startTurn() + TURN_TIMEOUT_MS
+ *   // expensive search: out.clear() and write something better
+ *   watchdog.finish(out);
+ *
+ * Needs CommandWriter pasted above it. */
+class Watchdog {
+  using Clock = chrono::steady_clock;
+
+  mutex lock;
+  condition_variable wake;
+  char fallback[1024];
+  int fallbackLength = 0;
+  Clock::time_point turnStart = Clock::now();
+  Clock::time_point deadline;
+  bool armed = false;
+  bool stopping = false;
+  atomic<bool> answered {true};   // Whoever flips this first owns the turn's output
+  thread worker;                  // Last, so it starts after everything above is ready
+
+  void run() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+      if (!armed) {
+        wake.wait(guard);
+        continue;
+      }
+
+      if (wake.wait_until(guard, deadline) != cv_status::timeout || !armed)
+        continue;
+
+      armed = false;
+      if (!answered.exchange(true)) {
+        int written = 0;
+        while (written < fallbackLength) {
+          int n = write(STDOUT_FILENO, fallback + written, fallbackLength - written);
+          if (n <= 0)
+            break;
+          written += n;
+        }
+        cerr << "Watchdog: turn overran; sent fallback" << endl;
+      }
+    }
+  }
+
+public:
+  Watchdog() : worker(&Watchdog::run, this) { }
+
+  ~Watchdog() {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+  }
+
+  /** Starts the turn's clock. Call it straight after the turn's first input is read,
+   * since the referee's time limit runs from when it sent that input. */
+  void startTurn() {
+    turnStart = Clock::now();
+  }
+
+  /** Copies out's pending commands as this turn's fallback, to be sent ms after the
+   * turn started. Call it once the fallback is written, before anything expensive. */
+  void arm(const CommandWriter &out, double ms) {
+    {
+      lock_guard<mutex> guard(lock);
+      fallbackLength = min<int>(out.size(), sizeof(fallback));
+      memcpy(fallback, out.data(), fallbackLength);
+      deadline = turnStart + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms));
+      armed = true;
+      answered = false;
+    }
+    wake.notify_one();
+  }
+
+  /** Sends out's commands, unless the watchdog beat us to it this turn, in which case
+   * they're discarded. Returns true if out was the answer that got sent. */
+  bool finish(CommandWriter &out) {
+    bool late = answered.exchange(true);
+    {
+      lock_guard<mutex> guard(lock);
+      armed = false;
+    }
+    wake.notify_one();
+
+    if (late) {
+      out.clear();
+      return false;
+    }
+    out.flush();
+    return true;
+  }
+};
+
+/** Named-phase timing. Open a ProfileScope at the top of a phase and it accrues calls
+ * and wall time to that name until it goes out of scope; nested scopes nest. The active
+ * phase is also what allocation and hardware-counter instrumentation attribute to.
+ * Phase tables are fixed-size arrays, so profiling never allocates.
+ *
+ * Compile with -DPROFILE to turn it on; ALLOC_PROFILE and PERF_COUNTERS turn it on too,
+ * since they attribute to its phases. Without a switch, ProfileScope is empty and
+ * endTurn() returns false straight away, so submitted bots pay nothing for the scopes. */
+#if defined(ALLOC_PROFILE) || defined(PERF_COUNTERS)
+#define PROFILE
+#endif
+
+#ifdef PROFILE
+
+namespace Profiler {
+  const int MAX_PHASES = 32;
+
+  struct Phase {
+    const char* name = nullptr;
+    long calls = 0;
+    double totalMs = 0;
+  };
+
+  inline Phase phases[MAX_PHASES];
+  inline int phaseCount = 0;
+  inline int current = -1;    // Index of the innermost open phase, or -1 outside any
+
+  /** Returns the index for a phase name, registering it on first use. */
+  inline int phaseId(const char* name) {
+    for (int i = 0; i < phaseCount; ++i)
+      if (phases[i].name == name || strcmp(phases[i].name, name) == 0)
+        return i;
+    if (phaseCount == MAX_PHASES)
+      return MAX_PHASES - 1;    // Out of room; lump the rest into the last phase
+    phases[phaseCount].name = name;
+    return phaseCount++;
+  }
+
+  inline const char* nameOf(int phase) {
+    return (phase < 0) ? "(no phase)" : phases[phase].name;
+  }
+
+  // Hooks for the optional instrumentation (AllocProfile.cpp, PerfCounters.cpp), which
+  // installs itself at startup when its build switch is on.
+  inline void (*onEnter)(int phase) = nullptr;
+  inline void (*onExit)(int phase) = nullptr;
+  inline void (*onTurnEnd)() = nullptr;
+  inline void (*reporters[4])() = {};
+  inline int reporterCount = 0;
+
+  inline void report() {
+    cerr << "Phase timings:" << endl;
+    for (int i = 0; i < phaseCount; ++i)
+      cerr << "  " << setw(24) << left << phases[i].name << right
+        << setw(8) << phases[i].calls << " calls "
+        << fixed << setprecision(3) << setw(10) << phases[i].totalMs << " ms" << endl;
+  }
+
+  /** Call once per turn, after the turn's output. Once stdin has closed, prints every
+   * report and returns true; the bot should then exit. Checking waits for the next
+   * turn's input, which is harmless with this turn's output already sent. */
+  inline bool endTurn() {
+    if (onTurnEnd)
+      onTurnEnd();
+
+    if ((cin >> ws).peek() != EOF)
+      return false;
+
+    report();
+    for (int i = 0; i < reporterCount; ++i)
+      reporters[i]();
+    return true;
+  }
+}
+
+class ProfileScope {
+  using Clock = chrono::steady_clock;
+
+  int phase;
+  int parent;
+  Clock::time_point start;
+
+public:
+  ProfileScope(const char* name)
+  : phase(Profiler::phaseId(name)),
+    parent(Profiler::current),
+    start(Clock::now())
+  {
+    Profiler::current = phase;
+    if (Profiler::onEnter)
+      Profiler::onEnter(phase);
+  }
+
+  ~ProfileScope() {
+    if (Profiler::onExit)
+      Profiler::onExit(phase);
+
+    Profiler::Phase &p = Profiler::phases[phase];
+    p.calls += 1;
+    p.totalMs += chrono::duration<double, milli>(Clock::now() - start).count();
+    Profiler::current = parent;
+  }
+};
+
+#else
+
+namespace Profiler {
+  inline bool endTurn() { return false; }
+}
+
+class ProfileScope {
+public:
+  ProfileScope(const char*) { }
+};
+
+#endif
+
+/* Allocation profiling
+
+Compile with -DALLOC_PROFILE to replace the global operator new/delete with counting
+versions. Every allocation is charged to the active ProfileScope (paste Profiler.cpp
+above this) for the current turn, and turns are closed by Profiler::endTurn(). Once
+stdin has closed, the report names the turn with the most allocations, its peak live
+bytes, and the phases responsible. Without the switch, this compiles to nothing.
+
+*/
+
+#ifdef ALLOC_PROFILE
+
+namespace AllocProfile {
+  struct Counts {
+    long allocs = 0;
+    long bytes = 0;
+  };
+
+  struct Turn {
+    int number = 0;
+    Counts total;
+    long peakLive = 0;
+    Counts byPhase[Profiler::MAX_PHASES + 1];   // [0] is outside any phase
+  };
+
+  inline Turn now;
+  inline Turn worst;
+  inline long live = 0;
+
+  inline void record(size_t bytes) {
+    now.total.allocs += 1;
+    now.total.bytes += bytes;
+    live += bytes;
+    now.peakLive = max(now.peakLive, live);
+
+    Counts &phase = now.byPhase[Profiler::current + 1];
+    phase.allocs += 1;
+    phase.bytes += bytes;
+  }
+
+  inline void report() {
+    cerr << "Worst turn for allocations: turn " << worst.number << ", "
+      << worst.total.allocs << " allocs, " << worst.total.bytes << " bytes, "
+      << worst.peakLive << " peak live bytes" << endl;
+
+    // Phases from most allocations to least; a selection sort over a handful is fine
+    bool shown[Profiler::MAX_PHASES + 1] = {};
+    for (int rank = 0; rank <= Profiler::MAX_PHASES; ++rank) {
+      int top = -1;
+      for (int i = 0; i <= Profiler::MAX_PHASES; ++i)
+        if (!shown[i] && worst.byPhase[i].allocs > 0
+            && (top < 0 || worst.byPhase[i].allocs > worst.byPhase[top].allocs))
+          top = i;
+      if (top < 0)
+        break;
+
+      shown[top] = true;
+      cerr << "  " << Profiler::nameOf(top - 1) << ": "
+        << worst.byPhase[top].allocs << " allocs, "
+        << worst.byPhase[top].bytes << " bytes" << endl;
+    }
+  }
+
+  inline void closeTurn() {
+    if (now.total.allocs > worst.total.allocs)
+      worst = now;
+
+    int number = now.number;
+    now = Turn();
+    now.number = number + 1;
+    now.peakLive = live;
+  }
+
+  inline bool installed = [] {
+    Profiler::onTurnEnd = closeTurn;
+    Profiler::reporters[Profiler::reporterCount++] = report;
+    return true;
+  }();
+}
+
+// Each block carries its size in a header, so delete can keep the live count right.
+// Kept out of line; inlined into containers, GCC mistakes the header offset for a bug.
+const size_t ALLOC_HEADER = alignof(max_align_t);
+
+__attribute__((noinline)) void* operator new(size_t bytes) {
+  void* block = malloc(bytes + ALLOC_HEADER);
+  if (!block)
+    throw bad_alloc();
+  *static_cast<size_t*>(block) = bytes;
+  AllocProfile::record(bytes);
+  return static_cast<char*>(block) + ALLOC_HEADER;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  if (!p)
+    return;
+  void* block = static_cast<char*>(p) - ALLOC_HEADER;
+  AllocProfile::live -= *static_cast<size_t*>(block);
+  free(block);
+}
+
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+#endif
+
+/* Hardware performance counters
+
+Compile with -DPERF_COUNTERS on Linux to sample cycles, instructions, L1 data read
+misses, last-level cache misses and branch misses around every ProfileScope (paste
+Profiler.cpp above this). Counts are inclusive of nested phases. The report, printed
+by Profiler::endTurn() once stdin closes, gives each phase's IPC and misses per
+thousand instructions. Low IPC with high cache MPKI means a phase is waiting on memory;
+high branch MPKI means it's mispredicting.
+
+Needs perf_event_paranoid <= 2, or CAP_PERFMON, and won't work on the CodinGame
+servers; it's for local runs against recorded inputs. Without the switch, this
+compiles to nothing.
+
+*/
+
+#ifdef PERF_COUNTERS
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace PerfCounters {
+  const int EVENTS = 5;
+  enum Event { Cycles, Instructions, L1Misses, LlcMisses, BranchMisses };
+
+  const int MAX_DEPTH = 16;
+
+  inline int fds[EVENTS] = {-1, -1, -1, -1, -1};
+  inline uint64_t totals[Profiler::MAX_PHASES][EVENTS];
+  inline uint64_t entered[MAX_DEPTH][EVENTS];   // Samples taken at each open scope
+  inline int depth = 0;
+
+  inline int openEvent(uint32_t type, uint64_t config, int group) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group < 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+  }
+
+  /** Reads all five counters with one syscall. */
+  inline bool sample(uint64_t out[EVENTS]) {
+    uint64_t buffer[1 + EVENTS];    // count, then values
+    if (read(fds[0], buffer, sizeof(buffer)) != sizeof(buffer))
+      return false;
+    memcpy(out, buffer + 1, sizeof(uint64_t) * EVENTS);
+    return true;
+  }
+
+  inline void enter(int /* phase */) {   // Totals are attributed on exit
+    if (depth < MAX_DEPTH)
+      sample(entered[depth]);
+    ++depth;
+  }
+
+  inline void exit(int phase) {
+    --depth;
+    uint64_t now[EVENTS];
+    if (depth >= MAX_DEPTH || !sample(now))
+      return;
+    for (int e = 0; e < EVENTS; ++e)
+      totals[phase][e] += now[e] - entered[depth][e];
+  }
+
+  inline void report() {
+    cerr << "Phase counters:" << endl;
+    cerr << "  " << setw(24) << left << "phase" << right
+      << setw(14) << "cycles" << setw(7) << "IPC"
+      << setw(9) << "L1 MPKI" << setw(10) << "LLC MPKI" << setw(10) << "br MPKI" << endl;
+
+    for (int i = 0; i < Profiler::phaseCount; ++i) {
+      const uint64_t* t = totals[i];
+      double kiloInstructions = max<uint64_t>(t[Instructions], 1) / 1000.0;
+      cerr << "  " << setw(24) << left << Profiler::phases[i].name << right
+        << setw(14) << t[Cycles]
+        << fixed << setprecision(2)
+        << setw(7) << double(t[Instructions]) / max<uint64_t>(t[Cycles], 1)
+        << setw(9) << t[L1Misses] / kiloInstructions
+        << setw(10) << t[LlcMisses] / kiloInstructions
+        << setw(10) << t[BranchMisses] / kiloInstructions << endl;
+    }
+  }
+
+  /** Opens the counter group and installs the profiler hooks; runs at startup. */
+  inline bool start() {
+    const uint64_t l1ReadMiss = PERF_COUNT_HW_CACHE_L1D
+      | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    fds[Cycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    fds[Instructions] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[0]);
+    fds[L1Misses] = openEvent(PERF_TYPE_HW_CACHE, l1ReadMiss, fds[0]);
+    fds[LlcMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, fds[0]);
+    fds[BranchMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, fds[0]);
+
+    for (int e = 0; e < EVENTS; ++e) {
+      if (fds[e] >= 0)
+        continue;
+      cerr << "PerfCounters: perf_event_open failed (" << strerror(errno) << "); disabled" << endl;
+      for (int f = 0; f < EVENTS; ++f)
+        if (fds[f] >= 0)
+          close(fds[f]);
+      return false;
+    }
+
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    Profiler::onEnter = enter;
+    Profiler::onExit = exit;
+    Profiler::reporters[Profiler::reporterCount++] = report;
+    return true;
+  }
+
+  inline bool started = start();
+}
+
+#endif
+
+/** A dense id→value container for small, frame-persistent entity ids.
+ * Values live contiguously in a fixed-capacity array in insertion order, so there is
+ * no per-entry node allocation and references handed out remain valid for the life
+ * of the map. Lookup is a single index into an id→slot table.
+ * @param T the value type; must be default-constructible. Slots are never erased or reused.
+ * @param Capacity the maximum number of distinct ids this map will ever hold. */
+template <class T, int Capacity>
+class IdSlotMap {
+  array<T, Capacity> values;
+  array<int, Capacity> ids;
+  vector<int> slotOf;   // id → slot, or -1 if unassigned
+  int count = 0;
+
+public:
+
+  int size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  T* begin() { return values.data(); }
+  T* end() { return values.data() + count; }
+  const T* begin() const { return values.data(); }
+  const T* end() const { return values.data() + count; }
+
+  /** Returns the entity id owning the value at the given slot. */
+  int idAt(int slot) const {
+    return ids[slot];
+  }
+
+  bool contains(int id) const {
+    return id >= 0 && id < int(slotOf.size()) && slotOf[id] >= 0;
+  }
+
+  /** Returns a pointer to the value for id, or nullptr if it has not been inserted. */
+  T* find(int id) {
+    return contains(id) ? &values[slotOf[id]] : nullptr;
+  }
+
+  const T* find(int id) const {
+    return contains(id) ? &values[slotOf[id]] : nullptr;
+  }
+
+  /** Returns a <value,bool> pair, where the bool is true if the id was newly inserted
+   * with a default value, and false if it was already present. */
+  pair<T&, bool> insert(int id) {
+    if (contains(id))
+      return {values[slotOf[id]], false};
+
+    if (id < 0)
+      throw invalid_argument("IdSlotMap ids must be non-negative.");
+    if (count == Capacity)
+      throw length_error("IdSlotMap is at capacity.");
+
+    if (id >= int(slotOf.size()))
+      slotOf.resize(id + 1, -1);
+
+    int slot = count++;
+    slotOf[id] = slot;
+    ids[slot] = id;
+    return {values[slot], true};
+  }
+
+  T& operator[](int id) {
+    return insert(id).first;
+  }
+
+  T& at(int id) {
+    T* value = find(id);
+    if (!value)
+      throw out_of_range("IdSlotMap has no entry for that id.");
+    return *value;
+  }
+};
+
+/** A vector with fixed, inline capacity: the elements live inside the object itself, so
+ * a StaticVector on the stack never touches the heap. Supports the subset of std::vector
+ * the bots use, including back_inserter and the <algorithm> iterator functions.
+ * Growing past N throws length_error rather than reallocating. */
+template <class T, int N>
+class StaticVector {
+  alignas(T) unsigned char storage[N * sizeof(T)];
+  int count = 0;
+
+public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using size_type = int;
+
+  StaticVector() { }
+
+  StaticVector(initializer_list<T> items) {
+    for (auto &item : items)
+      push_back(item);
+  }
+
+  template <class Iter>
+  StaticVector(Iter first, Iter last) {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  StaticVector(const StaticVector &other) {
+    for (auto &item : other)
+      push_back(item);
+  }
+
+  StaticVector& operator=(const StaticVector &other) {
+    if (this != &other) {
+      clear();
+      for (auto &item : other)
+        push_back(item);
+    }
+    return *this;
+  }
+
+  ~StaticVector() {
+    clear();
+  }
+
+  T* data() { return reinterpret_cast<T*>(storage); }
+  const T* data() const { return reinterpret_cast<const T*>(storage); }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + count; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + count; }
+
+  int size() const { return count; }
+  bool empty() const { return count == 0; }
+  bool full() const { return count == N; }
+  static constexpr int capacity() { return N; }
+
+  T& operator[](int i) { return data()[i]; }
+  const T& operator[](int i) const { return data()[i]; }
+
+  T& at(int i) {
+    if (i < 0 || i >= count)
+      throw out_of_range("StaticVector index out of range.");
+    return data()[i];
+  }
+
+  T& front() { return data()[0]; }
+  T& back() { return data()[count - 1]; }
+  const T& front() const { return data()[0]; }
+  const T& back() const { return data()[count - 1]; }
+
+  template <class... Args>
+  T& emplace_back(Args&&... args) {
+    if (count == N)
+      throw length_error("StaticVector is at capacity.");
+    T* item = new (data() + count) T(forward<Args>(args)...);
+    ++count;
+    return *item;
+  }
+
+  void push_back(const T &item) { emplace_back(item); }
+  void push_back(T &&item) { emplace_back(move(item)); }
+
+  void pop_back() {
+    data()[--count].~T();
+  }
+
+  void clear() {
+    while (count > 0)
+      pop_back();
+  }
+
+  void resize(int n) {
+    while (count > n)
+      pop_back();
+    while (count < n)
+      emplace_back();
+  }
+
+  template <class Iter>
+  void assign(Iter first, Iter last) {
+    clear();
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  /** Removes the element at pos by shifting the rest down; returns the following position. */
+  iterator erase(iterator pos) {
+    for (iterator it = pos; it + 1 != end(); ++it)
+      *it = move(*(it + 1));
+    pop_back();
+    return pos;
+  }
+
+  iterator erase(iterator first, iterator last) {
+    iterator out = first;
+    for (iterator it = last; it != end(); ++it, ++out)
+      *out = move(*it);
+    while (end() != out)
+      pop_back();
+    return first;
+  }
+};
+
 enum class EntityType {
   Monster = 0,
   Hero = 1,
@@ -124,6 +889,9 @@ const int HERO_ATK_POWER = 2;
 const int MONSTER_SPEED = 400;
 const int MANA_PER_ATTACK = 1;
 const int MANA_COST = 10;
+const int MAX_HEROES_PER_PLAYER = 3;
+const int TURN_TIMEOUT_MS = 45;   // Of the 50ms the referee allows
+const int MAX_MONSTERS = 128;    // More than the game will ever show at once
 
 /** A container for raw inputs from the game terminal. */
 class EntityData {
@@ -139,6 +907,7 @@ public:
   PlayerTarget threatFor;
 
   void read() {
+    ProfileScope scope("EntityData::read");
     int tmp;
 
     cin >> id;
@@ -167,18 +936,18 @@ class Entity {
 public:
   EntityData data;
 
-  void fill(EntityData &data) {
+  void fill(const EntityData &data) {
     this->data = data;
   }
 
   string nameId() const {
-    map<EntityType, string> ent_name {
-      {EntityType::Monster,  "Mon"},
-      {EntityType::Hero,     "Hero"},
-      {EntityType::Opponent, "Opp"}
+    static const char* const ent_name[] = {
+      "Mon",    // EntityType::Monster
+      "Hero",   // EntityType::Hero
+      "Opp",    // EntityType::Opponent
     };
     stringstream s;
-    s << ent_name[data.type] << " " << data.id;
+    s << ent_name[int(data.type)] << " " << data.id;
     return s.str();
   }
 
@@ -205,6 +974,7 @@ public:
 
   double distToTarget = 0;  // 'Target' being the base it's headed for.
   int targetedCount = 0;    // How many heroes are currently aiming at this target.
+  bool inferred = false;    // An unseen mirror twin, placed by FogTwins rather than read.
 
   // Estimates the ideal number of heroes who would be fighting this thing. A 'double' because it's more of a score.
   double idealTargetCount() const {
@@ -220,6 +990,72 @@ public:
   // }
 };
 
+/** A reference to an entity in an EntityStore: its slot index plus the generation that
+ * slot was on when the handle was made. A handle goes stale once its slot is recycled. */
+struct EntityHandle {
+  int index = -1;
+  int generation = -1;
+
+  bool operator==(const EntityHandle &other) const {
+    return (index == other.index && generation == other.generation);
+  }
+};
+
+/** Frame-scoped storage for entities. Process objects hold EntityHandles into it rather
+ * than copies, so changes they make (like targetedCount) land on the live entity.
+ * Storage capacity is kept between frames; clearing the store invalidates all handles. */
+template <class T>
+class EntityStore {
+  vector<T> entities;
+  vector<int> generations;
+
+public:
+
+  int size() const { return entities.size(); }
+
+  T* begin() { return entities.data(); }
+  T* end() { return entities.data() + entities.size(); }
+  const T* begin() const { return entities.data(); }
+  const T* end() const { return entities.data() + entities.size(); }
+
+  void clear() {
+    for (int i = 0; i < size(); ++i)
+      ++generations[i];
+    entities.clear();
+  }
+
+  EntityHandle add(const T &entity) {
+    int index = size();
+    if (index == int(generations.size()))
+      generations.push_back(0);
+    entities.push_back(entity);
+    return handleAt(index);
+  }
+
+  EntityHandle handleAt(int index) const {
+    return {index, generations[index]};
+  }
+
+  bool valid(const EntityHandle &handle) const {
+    return handle.index >= 0 && handle.index < size()
+      && generations[handle.index] == handle.generation;
+  }
+
+  /** Returns a pointer to the live entity, or nullptr if the handle is stale. */
+  T* get(const EntityHandle &handle) {
+    return valid(handle) ? &entities[handle.index] : nullptr;
+  }
+
+  /** Unchecked access; the handle is assumed valid. */
+  T& operator[](const EntityHandle &handle) {
+    return entities[handle.index];
+  }
+
+  const T& operator[](const EntityHandle &handle) const {
+    return entities[handle.index];
+  }
+};
+
 // TODO Learn how to pre-declare class interfaces to avoid this Monster->Base->Hero interwoven structure.
 class Base {
 public:
@@ -232,15 +1068,16 @@ public:
 
   const vector<Point> sentryPoses;
 
-  vector<Monster> known_monsters;
-  vector<Monster> threats;
+  EntityStore<Monster>& known_monsters;
+  StaticVector<EntityHandle, MAX_MONSTERS> threats;
 
-  Base(PlayerTarget playerId, Point pos, int n_heroes)
+  Base(PlayerTarget playerId, Point pos, int n_heroes, EntityStore<Monster>& monsters)
   : id(playerId),
     position(pos),
     numHeroes(n_heroes),
     isPlayer1(Point() == pos),
-    sentryPoses(getSentryPoses())
+    sentryPoses(getSentryPoses()),
+    known_monsters(monsters)
   { }
 
   void update() {
@@ -248,23 +1085,26 @@ public:
     cin.ignore();
   }
 
-  void assembleThreatList(vector<Monster> &monsters) {
-    known_monsters = monsters;
+  void assembleThreatList() {
+    ProfileScope scope("assembleThreatList");
     threats.clear();
 
-    for (auto monster : monsters) {
+    for (int i = 0; i < known_monsters.size(); ++i) {
+      EntityHandle handle = known_monsters.handleAt(i);
+      Monster &monster = known_monsters[handle];
+
       if (monster.data.threatFor != id)
         continue;
 
       if (id == PlayerTarget::Allied)
         monster.distToTarget = monster.data.position.distanceTo(position);
 
-      threats.push_back(monster);
+      threats.push_back(handle);
     }
 
     sort(threats.begin(), threats.end(),
-      [](const Monster &a, const Monster &b) {
-        return a.idealTargetCount() < b.idealTargetCount();
+      [this](const EntityHandle &a, const EntityHandle &b) {
+        return known_monsters[a].idealTargetCount() < known_monsters[b].idealTargetCount();
       });
   }
 
@@ -272,7 +1112,10 @@ public:
     if (threats.size() == 0)
       return true;
     return all_of(threats.begin(), threats.end(),
-      [](const Monster &m){ return m.targetedCount >= m.idealTargetCount(); });
+      [this](const EntityHandle &h) {
+        const Monster &m = known_monsters[h];
+        return m.targetedCount >= m.idealTargetCount();
+      });
   }
 
   operator string() const {
@@ -316,22 +1159,21 @@ enum class HeroRole {
     Attacker,
 };
 
-Monster DEFAULT_MON = Monster();
-
 class Hero : public Entity {
 public:
   Base* parent;
   bool nowTargeting;
-  Monster& target = DEFAULT_MON;
+  EntityHandle target;
   HeroRole role;
   Point restingPosition;
 
   int baseId;
 
   Point goal() const {
-    if (nowTargeting) {
-      cerr << nameId() << " -> " << target.nameId() << endl;
-      return getAttackPose(target);
+    const Monster* monster = parent->known_monsters.get(target);
+    if (nowTargeting && monster) {
+      cerr << nameId() << " -> " << monster->nameId() << endl;
+      return getAttackPose(*monster);
     }
     return restingPosition;
   }
@@ -351,20 +1193,47 @@ public:
     role = (baseId != 1) ? HeroRole::Defender : HeroRole::Attacker;
   }
 
-  void setTarget(Monster& monster) {
-    target = monster;
-    target.targetedCount = target.targetedCount + 1;
-    cerr << monster.nameId() << " mtc=" << monster.targetedCount << " ttc=" << target.targetedCount << endl;
-      // TODO *Sigh*... I can't get this increment out of this function.
-      // The process-repository pattern, so oft-used in my own work that I coined it myself, requires a long-ass ass-fuck unbroken reference chain in Cpp.
-      // Not undoable, I'm certain, but jesus fuck impractical.
-      // God, this is so irritating.
-      // If I'm not going to just restart in another language to rank high,
-      // I ~think~ I could do this with a singleton lookup service? Like, "Give me this ID" -> "Wham, bam, thank you." and then I have the object.
+  /** Targets the monster, if the handle still refers to one; a stale or empty handle
+   * leaves the hero untargeted. */
+  void setTarget(const EntityHandle &handle) {
+    // Handles resolve to the live monster in the base's store, so the increment is
+    // seen by every other hero (and by Base::threatsAccountedFor) this frame.
+    Monster *monster = parent->known_monsters.get(handle);
+    if (!monster)
+      return;
+
+    target = handle;
+    monster->targetedCount = monster->targetedCount + 1;
+    cerr << monster->nameId() << " tc=" << monster->targetedCount << endl;
     nowTargeting = true;
   }
 
+  /** Returns the handle of the known monster closest to this hero which satisfies the
+   * predicate, or an invalid handle if there is none. */
+  template <class Predicate>
+  EntityHandle closestMonster(Predicate accept) const {
+    const EntityStore<Monster> &monsters = parent->known_monsters;
+    EntityHandle closest;
+    double closestDist = 0;
+
+    for (int i = 0; i < monsters.size(); ++i) {
+      EntityHandle handle = monsters.handleAt(i);
+      const Monster &monster = monsters[handle];
+      if (!accept(monster))
+        continue;
+
+      double dist = monster.data.position.distanceTo(data.position);
+      if (closest.index < 0 || dist < closestDist) {
+        closest = handle;
+        closestDist = dist;
+      }
+    }
+
+    return closest;
+  }
+
   void determineGoal() {
+    ProfileScope scope("determineGoal");
     cerr << nameId() << " threats=";
     if (parent->threatsAccountedFor())
       cerr << "OK";
@@ -387,19 +1256,20 @@ public:
   }
 
   Point getAttackPose(const Monster& monster) const {
-    vector<Monster> known_monsters = parent->known_monsters;
+    ProfileScope scope("getAttackPose");
+    const EntityStore<Monster> &known_monsters = parent->known_monsters;
 
-    vector<Monster> nearby_monsters;
+    StaticVector<Monster, MAX_MONSTERS> nearby_monsters;
     nearby_monsters.push_back(monster);   // Always include self: nearby_mons is never empty
 
     copy_if(known_monsters.begin(), known_monsters.end(), back_inserter(nearby_monsters),
-      [monster](Monster& other) {
+      [&monster](const Monster& other) {
         bool notTarget = monster.data.id != other.data.id;
         bool nearby = monster.data.position.distanceTo(other.data.position) < HERO_ATTACK_RADIUS*1.66;
         return notTarget && nearby;
       });
 
-    vector<Point> nearby_points;
+    StaticVector<Point, MAX_MONSTERS> nearby_points;
     for (auto monster : nearby_monsters)
       nearby_points.push_back(monster.data.position + monster.data.speed);
 
@@ -407,9 +1277,9 @@ public:
 
     // Pick a destination some distance ahead of the target proportional
     // to the Hero's distance to the target; more efficient pathing.
-    double dist = target.data.position.distanceTo(data.position);
+    double dist = monster.data.position.distanceTo(data.position);
     double distFactor = dist / HERO_ATTACK_RADIUS;
-    Point projected = average_position + target.data.speed * distFactor;
+    Point projected = average_position + monster.data.speed * distFactor;
 
     return projected;
   }
@@ -418,15 +1288,13 @@ public:
     restingPosition = getBaseRestingPose();
     cerr << nameId() << " c:Explore" << endl;
     
-    auto monsters = parent->known_monsters;
+    auto &monsters = parent->known_monsters;
 
     if (monsters.size() == 0)
         return;
 
-    vector<Monster> culled_monsters;
-
-    copy_if(monsters.begin(), monsters.end(), back_inserter(culled_monsters),
-      [this](Monster& monster) {
+    EntityHandle closest = closestMonster(
+      [this](const Monster& monster) {
         double distFromSelf = monster.data.position.distanceTo(data.position);
         bool closeToSelf = distFromSelf < HERO_ATTACK_RADIUS*2.5;
         bool farFromBase = (role == HeroRole::Defender && monster.distToTarget > BASE_SIGHT_RADIUS*1.25);
@@ -434,55 +1302,33 @@ public:
         return closeToSelf && !farFromBase && !marked;
       });
 
-    if (culled_monsters.size() == 0)
+    if (!monsters.valid(closest))
       return;
 
-    auto closest = min_element(culled_monsters.begin(), culled_monsters.end(),
-      [this](const Monster &a, const Monster &b) {
-        double a_dist = a.data.position.distanceTo(this->data.position);
-        double b_dist = b.data.position.distanceTo(this->data.position);
-        return a_dist < b_dist;
-      });
-
-    setTarget(*closest);
+    setTarget(closest);
   }
 
   void attack() {
-    auto threats = parent->threats;
+    const PlayerTarget baseId = parent->id;
     cerr << nameId() << " c:Attack" << endl;
 
-    vector<Monster> culled_threats;
-    copy_if(threats.begin(), threats.end(), back_inserter(culled_threats),
-      [](Monster &m) {
-        return m.targetedCount < m.idealTargetCount();
+    // Threats are exactly the known monsters headed for our base
+    EntityHandle closest = closestMonster(
+      [baseId](const Monster &m) {
+        return m.data.threatFor == baseId
+          && m.targetedCount < m.idealTargetCount();
       });
 
-    if (culled_threats.size() == 0)
-      culled_threats = threats;
-
-    auto closest = min_element(culled_threats.begin(), culled_threats.end(),
-      [this](const Monster &a, const Monster &b) {
-        double a_dist = a.data.position.distanceTo(this->data.position);
-        double b_dist = b.data.position.distanceTo(this->data.position);
-        return a_dist < b_dist;
-      });
+    if (!parent->known_monsters.valid(closest))
+      closest = closestMonster(
+        [baseId](const Monster &m) { return m.data.threatFor == baseId; });
 
-    setTarget(*closest);
-
-    // Copy comparison test
-    int closestId = closest->data.id;
-    auto findId = [closestId](Monster &m) { return m.data.id == closestId; };
-    cerr << nameId() << " ======" << endl;;
-    cerr << "Final  tc=" << closest->targetedCount << endl;
-    // cerr << "Culled tc=" << find(culled_threats.begin(), culled_threats.end(), findId)->targetedCount << endl;
-    // cerr << "Threat tc=" << find(threats.begin(), threats.end(), findId)->targetedCount << endl;
-    // cerr << "Parent tc=" << find(parent->threats.begin(), parent->threats.end(), findId)->targetedCount << endl;
+    setTarget(closest);
   }
 
-  string getCommand() {
-    stringstream s;
-    s << "MOVE " << string(goal());
-    return s.str();
+  void writeCommand(CommandWriter &out) const {
+    Point p = goal();
+    out << "MOVE " << p.x << ' ' << p.y << '\n';
   }
 
 };
@@ -494,6 +1340,386 @@ public:
   }
 };
 
+/** Returns where something at `from` ends up after moving toward `to` by at most `speed`. */
+Point stepToward(const Point &from, const Point &to, int speed) {
+  double dist = from.distanceTo(to);
+  if (dist <= speed)
+    return to;
+  return from + (to - from) * (speed / dist);
+}
+
+/** Monsters spawn in pairs mirrored about the board centre: consecutive ids after the
+ * heroes' (so n and n ^ 1), opposite positions and speeds, the same health. When one of
+ * a pair is sighted and the other never has been, this keeps an inferred copy of the
+ * other, dead-reckoned frame by frame, so threats still in the fog can be planned for.
+ *
+ * An inferred twin is dropped once it is seen (the real entry takes over), once it
+ * should be within our sight but isn't there, or once it leaves the board or reaches a
+ * base. It won't know about winds, controls or hits the opponent has dealt it. */
+class FogTwins {
+  vector<bool> seen;    // Indexed by monster id
+  StaticVector<EntityData, MAX_MONSTERS> inferred;
+
+  bool wasSeen(int id) const {
+    return id < int(seen.size()) && seen[id];
+  }
+
+  bool isInferred(int id) const {
+    return any_of(inferred.begin(), inferred.end(),
+      [id](const EntityData &twin) { return twin.id == id; });
+  }
+
+  static PlayerTarget mirrored(PlayerTarget target) {
+    if (target == PlayerTarget::Allied)
+      return PlayerTarget::Opponent;
+    if (target == PlayerTarget::Opponent)
+      return PlayerTarget::Allied;
+    return target;
+  }
+
+  /** Moves an inferred twin one frame, as the referee would; returns false if it's gone. */
+  static bool advance(EntityData &twin, const Base &base) {
+    twin.position = twin.position + twin.speed;
+    if (twin.shieldLife > 0)
+      --twin.shieldLife;
+
+    if (twin.position.x < 0 || twin.position.x > BOARD_DIM.x
+        || twin.position.y < 0 || twin.position.y > BOARD_DIM.y)
+      return false;
+
+    const Point bases[] = {base.position, BOARD_DIM - base.position};
+    const PlayerTarget owners[] = {PlayerTarget::Allied, PlayerTarget::Opponent};
+    for (int b = 0; b < 2; ++b) {
+      double dist = twin.position.distanceTo(bases[b]);
+      if (dist <= BASE_DAMAGE_RADIUS)
+        return false;
+      if (dist <= BASE_DETECTION_RADIUS) {
+        twin.speed = stepToward(twin.position, bases[b], MONSTER_SPEED) - twin.position;
+        twin.nearBase = true;
+        twin.threatFor = owners[b];
+      }
+    }
+    return true;
+  }
+
+  static bool inSight(const Point &p, const Base &base, const IdSlotMap<Hero, MAX_HEROES_PER_PLAYER> &heroes) {
+    if (p.distanceTo(base.position) <= BASE_SIGHT_RADIUS)
+      return true;
+    return any_of(heroes.begin(), heroes.end(),
+      [&p](const Hero &hero) { return p.distanceTo(hero.data.position) <= HERO_SIGHT_RADIUS; });
+  }
+
+public:
+
+  /** Call once a frame, after the frame's sighted monsters are in the store and the
+   * heroes are filled; adds the inferred twins to the store. */
+  void update(EntityStore<Monster> &monsters, const Base &base, const IdSlotMap<Hero, MAX_HEROES_PER_PLAYER> &heroes) {
+    ProfileScope scope("FogTwins::update");
+
+    inferred.erase(
+      remove_if(inferred.begin(), inferred.end(),
+        [&base](EntityData &twin) { return !advance(twin, base); }),
+      inferred.end());
+
+    StaticVector<int, MAX_MONSTERS> sighted;
+    for (const Monster &monster : monsters) {
+      int id = monster.data.id;
+      if (id >= int(seen.size()))
+        seen.resize(id + 1, false);
+      if (!seen[id])
+        sighted.push_back(monster.data.id);
+      seen[id] = true;
+    }
+
+    // Confirmed twins give way to the real thing
+    inferred.erase(
+      remove_if(inferred.begin(), inferred.end(),
+        [this](const EntityData &twin) { return wasSeen(twin.id); }),
+      inferred.end());
+
+    for (const Monster &monster : monsters) {
+      int twinId = monster.data.id ^ 1;
+      bool firstSighting = find(sighted.begin(), sighted.end(), monster.data.id) != sighted.end();
+      if (!firstSighting || wasSeen(twinId) || isInferred(twinId) || inferred.full())
+        continue;
+
+      EntityData twin = monster.data;
+      twin.id = twinId;
+      twin.position = BOARD_DIM - monster.data.position;
+      twin.speed = -monster.data.speed;
+      twin.threatFor = mirrored(monster.data.threatFor);
+      inferred.push_back(twin);
+    }
+
+    // Anything we ought to be able to see but can't is no longer where we thought
+    inferred.erase(
+      remove_if(inferred.begin(), inferred.end(),
+        [&](const EntityData &twin) { return inSight(twin.position, base, heroes); }),
+      inferred.end());
+
+    for (const EntityData &twin : inferred) {
+      Monster monster;
+      monster.fill(twin);
+      monster.inferred = true;
+      monsters.add(monster);
+    }
+  }
+};
+
+/** Plans our defenders' work over the next frames rather than one frame at a time:
+ * each hero gets an ordered list of threats to run down, so a hero can finish one
+ * monster and still reach the next before it gets to the base. A monster is taken by
+ * one hero at a time; the hero intercepts it as early as it can and stays on it until
+ * it dies. Schedules are compared on the number of monsters left to hit the base
+ * within the horizon, then on the sum of kill frames.
+ *
+ * The search is a depth-first branch and bound: the hero that comes free soonest picks
+ * its next monster or stops, and a branch is cut when even saving every threat some
+ * hero could still reach wouldn't beat the best schedule so far. Each frame starts
+ * from last frame's schedule, re-timed against the new positions, so the bound is
+ * usually tight from the outset. The search stops early at its time budget. */
+class DefenceScheduler {
+public:
+  static const int HORIZON = 15;          // Frames looked ahead
+  static const int MAX_PLANNED = 12;      // Most urgent threats considered
+  static constexpr double BUDGET_MS = 8;  // Of the frame's TURN_TIMEOUT_MS
+
+  /** Rebuilds the schedule for the base's defenders against its current threats. */
+  void plan(const Base &base, const IdSlotMap<Hero, MAX_HEROES_PER_PLAYER> &heroes) {
+    ProfileScope scope("DefenceScheduler::plan");
+    start = chrono::steady_clock::now();
+    nodes = 0;
+    outOfTime = false;
+
+    collectThreats(base);
+    heroCount = 0;
+    for (const Hero &hero : heroes)
+      if (hero.role == HeroRole::Defender) {
+        heroIds[heroCount] = hero.data.id;
+        heroStart[heroCount] = hero.data.position;
+        ++heroCount;
+      }
+
+    best = Schedule();
+    best.damage = threatCount;
+    reusePrevious();
+
+    Schedule current;
+    current.damage = 0;
+    int free[MAX_HEROES_PER_PLAYER] = {};
+    Point at[MAX_HEROES_PER_PLAYER];
+    copy(heroStart, heroStart + heroCount, at);
+    search(current, free, at, (1 << heroCount) - 1, (1 << threatCount) - 1);
+
+    // Remember what we settled on by monster id, for next frame's starting point
+    for (int h = 0; h < heroCount; ++h) {
+      previous[h].heroId = heroIds[h];
+      previous[h].monsterIds.clear();
+      for (int t : best.order[h])
+        previous[h].monsterIds.push_back(threats[t].id);
+    }
+    previousCount = heroCount;
+  }
+
+  /** The monster this hero should go for now, or an invalid handle if the schedule has
+   * nothing for it. */
+  EntityHandle targetFor(const Hero &hero) const {
+    for (int h = 0; h < heroCount; ++h)
+      if (heroIds[h] == hero.data.id && !best.order[h].empty())
+        return threats[best.order[h].front()].handle;
+    return EntityHandle();
+  }
+
+  /** Monsters expected to reach the base within the horizon under the current schedule. */
+  int expectedDamage() const { return best.damage; }
+
+private:
+  static const int NEVER = 1 << 20;
+
+  struct Threat {
+    EntityHandle handle;
+    int id;
+    int hitsToKill;
+    int hitFrame;                   // Frame on which it reaches the base, if left alone
+    Point path[HORIZON + 1];        // Where it stands at the start of each frame
+  };
+
+  struct Schedule {
+    int damage = NEVER;
+    int frames = 0;
+    StaticVector<int, MAX_PLANNED> order[MAX_HEROES_PER_PLAYER];   // Threat indices
+
+    bool betterThan(const Schedule &other) const {
+      return damage < other.damage || (damage == other.damage && frames < other.frames);
+    }
+  };
+
+  struct Remembered {
+    int heroId;
+    StaticVector<int, MAX_PLANNED> monsterIds;
+  };
+
+  Threat threats[MAX_PLANNED];
+  int threatCount = 0;
+  int heroIds[MAX_HEROES_PER_PLAYER];
+  Point heroStart[MAX_HEROES_PER_PLAYER];
+  int heroCount = 0;
+
+  Schedule best;
+  Remembered previous[MAX_HEROES_PER_PLAYER];
+  int previousCount = 0;
+
+  chrono::steady_clock::time_point start;
+  long nodes = 0;
+  bool outOfTime = false;
+
+  /** Keeps the threats that would reach the base within the horizon, most urgent first. */
+  void collectThreats(const Base &base) {
+    threatCount = 0;
+    StaticVector<Threat, MAX_MONSTERS> urgent;
+
+    for (const EntityHandle &handle : base.threats) {
+      const Monster &monster = base.known_monsters[handle];
+      Threat threat;
+      threat.handle = handle;
+      threat.id = monster.data.id;
+      threat.hitsToKill = (monster.data.hp + HERO_ATK_POWER - 1) / HERO_ATK_POWER;
+      threat.hitFrame = NEVER;
+
+      // The referee's motion rules, for one monster
+      Point position = monster.data.position;
+      Point speed = monster.data.speed;
+      threat.path[0] = position;
+      for (int t = 1; t <= HORIZON; ++t) {
+        position = position + speed;
+        double distToBase = position.distanceTo(base.position);
+        if (distToBase <= BASE_DAMAGE_RADIUS && threat.hitFrame == NEVER)
+          threat.hitFrame = t;
+        else if (distToBase <= BASE_DETECTION_RADIUS)
+          speed = stepToward(position, base.position, MONSTER_SPEED) - position;
+        threat.path[t] = position;
+      }
+
+      if (threat.hitFrame != NEVER)
+        urgent.push_back(threat);
+    }
+
+    sort(urgent.begin(), urgent.end(),
+      [](const Threat &a, const Threat &b) { return a.hitFrame < b.hitFrame; });
+    for (int i = 0; i < urgent.size() && threatCount < MAX_PLANNED; ++i)
+      threats[threatCount++] = urgent[i];
+  }
+
+  /** The frame on which a hero free from `from` at `at` kills the threat, or NEVER if it
+   * can't before the threat reaches the base. Heroes move, then hit, then monsters move. */
+  int killFrame(const Threat &threat, int from, const Point &at) const {
+    for (int t = from + 1; t <= threat.hitFrame; ++t) {
+      double reach = HERO_SPEED * double(t - from) + HERO_ATTACK_RADIUS;
+      if (at.distanceTo(threat.path[t - 1]) > reach)
+        continue;
+      int kill = t + threat.hitsToKill - 1;
+      return (kill <= threat.hitFrame) ? kill : NEVER;
+    }
+    return NEVER;
+  }
+
+  void reusePrevious() {
+    Schedule seeded;
+    seeded.damage = threatCount;
+    int taken = 0;
+
+    for (int h = 0; h < heroCount; ++h) {
+      const Remembered* memory = nullptr;
+      for (int p = 0; p < previousCount; ++p)
+        if (previous[p].heroId == heroIds[h])
+          memory = &previous[p];
+      if (!memory)
+        continue;
+
+      int free = 0;
+      Point at = heroStart[h];
+      for (int id : memory->monsterIds)
+        for (int t = 0; t < threatCount; ++t) {
+          if (threats[t].id != id || (taken >> t & 1))
+            continue;
+          int kill = killFrame(threats[t], free, at);
+          if (kill == NEVER)
+            continue;
+          seeded.order[h].push_back(t);
+          seeded.frames += kill;
+          --seeded.damage;
+          taken |= 1 << t;
+          free = kill;
+          at = threats[t].path[kill - 1];
+        }
+    }
+
+    if (seeded.betterThan(best))
+      best = seeded;
+  }
+
+  void search(Schedule &current, int free[], Point at[], int active, int remaining) {
+    if ((++nodes & 255) == 0)
+      outOfTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() > BUDGET_MS;
+    if (outOfTime)
+      return;
+
+    // Bound: every remaining threat some active hero could still save, saved
+    int savable = 0, unsavable = 0;
+    for (int t = 0; t < threatCount; ++t) {
+      if (!(remaining >> t & 1))
+        continue;
+      bool reachable = false;
+      for (int h = 0; h < heroCount && !reachable; ++h)
+        reachable = (active >> h & 1) && killFrame(threats[t], free[h], at[h]) != NEVER;
+      (reachable ? savable : unsavable)++;
+    }
+
+    Schedule bound = current;
+    bound.damage = current.damage + unsavable;
+    if (!bound.betterThan(best))
+      return;
+
+    if (savable == 0) {
+      current.damage += unsavable;
+      if (current.betterThan(best))
+        best = current;
+      current.damage -= unsavable;
+      return;
+    }
+
+    // The hero who comes free soonest chooses next
+    int h = -1;
+    for (int i = 0; i < heroCount; ++i)
+      if ((active >> i & 1) && (h < 0 || free[i] < free[h]))
+        h = i;
+
+    int freeBefore = free[h];
+    Point atBefore = at[h];
+    for (int t = 0; t < threatCount; ++t) {
+      if (!(remaining >> t & 1))
+        continue;
+      int kill = killFrame(threats[t], freeBefore, atBefore);
+      if (kill == NEVER)
+        continue;
+
+      current.order[h].push_back(t);
+      current.frames += kill;
+      free[h] = kill;
+      at[h] = threats[t].path[kill - 1];
+
+      search(current, free, at, active, remaining & ~(1 << t));
+
+      current.order[h].pop_back();
+      current.frames -= kill;
+      free[h] = freeBefore;
+      at[h] = atBefore;
+    }
+
+    // Or this hero stops here and leaves the rest to the others
+    search(current, free, at, active & ~(1 << h), remaining);
+  }
+};
 
 ////////////////////////////////////////
 ////////  Main                  /////////
@@ -507,15 +1733,21 @@ int main() {
   cin >> heroes_per_player;
   cin.ignore();
 
-  Base allyBase(PlayerTarget::Allied, base_pos, heroes_per_player);
-  Base oppBase(PlayerTarget::Opponent, BOARD_DIM - base_pos, heroes_per_player);
+  // Monsters are only stored per frame; heroes refer into this by handle
+  EntityStore<Monster> monsters;
+  FogTwins fogTwins;
+  DefenceScheduler scheduler;
+
+  Base allyBase(PlayerTarget::Allied, base_pos, heroes_per_player, monsters);
+  Base oppBase(PlayerTarget::Opponent, BOARD_DIM - base_pos, heroes_per_player, monsters);
 
   vector<EntityData> entity_data;
+  CommandWriter out;
+  Watchdog watchdog;
 
   // maps for inter-frame, object-entity id matching
-  vector<Monster> monsters;
-  map<int, Hero> known_heroes;
-  map<int, Opponent> known_opponents;
+  IdSlotMap<Hero, MAX_HEROES_PER_PLAYER> known_heroes;
+  IdSlotMap<Opponent, MAX_HEROES_PER_PLAYER> known_opponents;
 
   // TODO A first-frame/rest-frames dynamic would be nice.
 
@@ -529,6 +1761,7 @@ int main() {
     ////// Read from cin phase
 
     allyBase.update();
+    watchdog.startTurn();
     oppBase.update();
 
     // Fill entity list
@@ -547,14 +1780,15 @@ int main() {
         {
           Monster m;
           m.fill(data);
-          monsters.push_back(m);
+          monsters.add(m);
           break;
         }
         case (EntityType::Hero):
         {
-          if (known_heroes.find(data.id) == known_heroes.end())
-            known_heroes[data.id].init(allyBase, data);
-          known_heroes[data.id].fill(data);
+          auto [hero, isNew] = known_heroes.insert(data.id);
+          if (isNew)
+            hero.init(allyBase, data);
+          hero.fill(data);
           break;
         }
         case (EntityType::Opponent):
@@ -563,23 +1797,54 @@ int main() {
       }
     }
 
+    fogTwins.update(monsters, allyBase, known_heroes);
+
     ////// Configure instructions for this frame phase
 
-    allyBase.assembleThreatList(monsters);
+    allyBase.assembleThreatList();
 
-    for (auto& [id, hero] : known_heroes)
+    for (Hero& hero : known_heroes)
       hero.processData();
 
-    for (auto& [id, hero] : known_heroes) {
+    // Every hero's greedy goal is the fallback; the planners below run under the
+    // watchdog, and their commands replace it
+    for (Hero& hero : known_heroes) {
       hero.determineGoal();
-      cout << hero.getCommand() << endl;
+      hero.writeCommand(out);
     }
+    watchdog.arm(out, TURN_TIMEOUT_MS);
+    out.clear();
+
+    // Drop the greedy claims, so the scheduler's defenders start from untargeted monsters
+    for (Monster& m : monsters)
+      m.targetedCount = 0;
+    for (Hero& hero : known_heroes)
+      hero.processData();
+
+    // Scheduled defenders claim their monsters first, so everyone else sees them taken
+    scheduler.plan(allyBase, known_heroes);
+    cerr << "Schedule damage=" << scheduler.expectedDamage() << endl;
+    for (Hero& hero : known_heroes) {
+      EntityHandle scheduled = scheduler.targetFor(hero);
+      if (monsters.valid(scheduled))
+        hero.setTarget(scheduled);
+    }
+
+    for (Hero& hero : known_heroes) {
+      if (!hero.nowTargeting)
+        hero.determineGoal();
+      hero.writeCommand(out);
+    }
+    watchdog.finish(out);
 
     for (Monster& m : monsters) {
       if (m.targetedCount > 0)
         cerr << m.nameId() << " " << m.targetedCount << endl;
     }
 
+    if (Profiler::endTurn())
+      return 0;
+
     // TODO Distance optimizing.
     // If two heroes have goals which can be distance minimized by trading,
     // then they will trade targets and HeroRoles; like a soul-swap.
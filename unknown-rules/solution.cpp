@@ -5,6 +5,14 @@
 #include <algorithm>
 #include <cmath>
 
+#include <cstring>
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
 using namespace std;
 
 /**
@@ -101,6 +109,204 @@ public:
 
 };
 
+/** Builds a turn's output in a buffer and hands it to the OS with one write() call; no
+ * iostreams, locales or per-line flushes. Integers are formatted two digits at a time
+ * from a lookup table. The buffer grows rather than flushing early, so nothing reaches
+ * stdout before flush(); the Watchdog relies on that to discard a late answer.
+ *
+ *   out << "MOVE " << x << ' ' << y << '\n';
+ *   out.flush();   // once, after the turn's last command
+ *
+ * Don't mix with cout in the same bot; the two buffers would interleave. */
+class CommandWriter {
+  vector<char> buffer = vector<char>(4096);
+  int length = 0;
+
+  void reserve(int n) {
+    if (length + n > int(buffer.size()))
+      buffer.resize(max<size_t>(buffer.size() * 2, length + n));
+  }
+
+public:
+
+  CommandWriter& operator<<(char c) {
+    reserve(1);
+    buffer[length++] = c;
+    return *this;
+  }
+
+  CommandWriter& operator<<(const char* s) {
+    int n = strlen(s);
+    reserve(n);
+    memcpy(buffer.data() + length, s, n);
+    length += n;
+    return *this;
+  }
+
+  CommandWriter& operator<<(const string &s) {
+    reserve(s.size());
+    memcpy(buffer.data() + length, s.data(), s.size());
+    length += s.size();
+    return *this;
+  }
+
+  CommandWriter& operator<<(int n) {
+    static const char digitPairs[] =
+      "00010203040506070809" "10111213141516171819" "20212223242526272829"
+      "30313233343536373839" "40414243444546474849" "50515253545556575859"
+      "60616263646566676869" "70717273747576777879" "80818283848586878889"
+      "90919293949596979899";
+
+    reserve(11);
+    unsigned int u = (n < 0) ? 0u - unsigned(n) : unsigned(n);
+    if (n < 0)
+      buffer[length++] = '-';
+
+    char digits[10];
+    int i = 10;
+    while (u >= 100) {
+      int pair = (u % 100) * 2;
+      u /= 100;
+      digits[--i] = digitPairs[pair + 1];
+      digits[--i] = digitPairs[pair];
+    }
+    if (u >= 10) {
+      digits[--i] = digitPairs[u * 2 + 1];
+      digits[--i] = digitPairs[u * 2];
+    }
+    else
+      digits[--i] = '0' + u;
+
+    memcpy(buffer.data() + length, digits + i, 10 - i);
+    length += 10 - i;
+    return *this;
+  }
+
+  const char* data() const { return buffer.data(); }
+  int size() const { return length; }
+
+  /** Discards everything buffered. */
+  void clear() {
+    length = 0;
+  }
+
+  /** Writes everything buffered to stdout. */
+  void flush() {
+    int written = 0;
+    while (written < length) {
+      int n = write(STDOUT_FILENO, buffer.data() + written, length - written);
+      if (n <= 0)
+        break;
+      written += n;
+    }
+    length = 0;
+  }
+};
+
+/** Guarantees an answer every turn. The turn's clock starts when its first input is
+ * read. The bot then writes a cheap fallback command into its CommandWriter and arms
+ * the watchdog with it, before any expensive thinking. If finish() hasn't been called
+ * by the deadline, a background thread writes the fallback itself, and whatever the bot
+ * sends later that turn is discarded instead.
+ *
+ *   cin >> ...;                            // the turn's first read; blocks until it arrives
+ *   watchdog.startTurn();
+ *   // read the rest; out << fallback...;
+ *   watchdog.arm(out, TURN_TIMEOUT_MS);    // deadline is startTurn() + TURN_TIMEOUT_MS
+ *   // expensive search: out.clear() and write something better
+ *   watchdog.finish(out);
+ *
+ * Needs CommandWriter pasted above it. */
+class Watchdog {
+  using Clock = chrono::steady_clock;
+
+  mutex lock;
+  condition_variable wake;
+  char fallback[1024];
+  int fallbackLength = 0;
+  Clock::time_point turnStart = Clock::now();
+  Clock::time_point deadline;
+  bool armed = false;
+  bool stopping = false;
+  atomic<bool> answered {true};   // Whoever flips this first owns the turn's output
+  thread worker;                  // Last, so it starts after everything above is ready
+
+  void run() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+      if (!armed) {
+        wake.wait(guard);
+        continue;
+      }
+
+      if (wake.wait_until(guard, deadline) != cv_status::timeout || !armed)
+        continue;
+
+      armed = false;
+      if (!answered.exchange(true)) {
+        int written = 0;
+        while (written < fallbackLength) {
+          int n = write(STDOUT_FILENO, fallback + written, fallbackLength - written);
+          if (n <= 0)
+            break;
+          written += n;
+        }
+        cerr << "Watchdog: turn overran; sent fallback" << endl;
+      }
+    }
+  }
+
+public:
+  Watchdog() : worker(&Watchdog::run, this) { }
+
+  ~Watchdog() {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+  }
+
+  /** Starts the turn's clock. Call it straight after the turn's first input is read,
+   * since the referee's time limit runs from when it sent that input. */
+  void startTurn() {
+    turnStart = Clock::now();
+  }
+
+  /** Copies out's pending commands as this turn's fallback, to be sent ms after the
+   * turn started. Call it once the fallback is written, before anything expensive. */
+  void arm(const CommandWriter &out, double ms) {
+    {
+      lock_guard<mutex> guard(lock);
+      fallbackLength = min<int>(out.size(), sizeof(fallback));
+      memcpy(fallback, out.data(), fallbackLength);
+      deadline = turnStart + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms));
+      armed = true;
+      answered = false;
+    }
+    wake.notify_one();
+  }
+
+  /** Sends out's commands, unless the watchdog beat us to it this turn, in which case
+   * they're discarded. Returns true if out was the answer that got sent. */
+  bool finish(CommandWriter &out) {
+    bool late = answered.exchange(true);
+    {
+      lock_guard<mutex> guard(lock);
+      armed = false;
+    }
+    wake.notify_one();
+
+    if (late) {
+      out.clear();
+      return false;
+    }
+    out.flush();
+    return true;
+  }
+};
+
 namespace Dirs {
   Point Up(0,-1);
   Point Down(0,1);
@@ -113,6 +319,8 @@ namespace Dirs {
   Point RightTurn(Down);
 }
 
+const int TURN_TIMEOUT_MS = 90;   // The referee allows 100ms
+
 struct Board
 {
   int width, height, numPoints;
@@ -187,6 +395,8 @@ int main()
   Board board;
   Walls local;
   Player player;
+  CommandWriter out;
+  Watchdog watchdog;
 
   cin >> board.width;
   cin.ignore();
@@ -212,6 +422,7 @@ int main()
 
     cin >> local.up;
     cin.ignore();
+    watchdog.startTurn();
     cin >> local.right;
     cin.ignore();
     cin >> local.down;
@@ -228,6 +439,16 @@ int main()
       vectors.push_back(v);
     }
 
+    // E -> c.d     left
+    // A -> c.b     right
+    // D -> c.c     down
+    // C -> c.a     up
+
+    // The wall-follower move is the answer, and armed as the fallback before the map
+    // work below, whose debug drawing is the slow part of the turn
+    out << player.nextCmd(local) << '\n';
+    watchdog.arm(out, TURN_TIMEOUT_MS);
+
     // Report given points
     for (Point &v : vectors)
     {
@@ -265,12 +486,6 @@ int main()
     }
 
     // Output
-
-    // E -> c.d     left
-    // A -> c.b     right
-    // D -> c.c     down
-    // C -> c.a     up
-
-    cout << player.nextCmd(local) << endl;
+    watchdog.finish(out);
   }
 }
\ No newline at end of file